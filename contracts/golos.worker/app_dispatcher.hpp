@@ -1,57 +1,128 @@
-#include <iostream>
 #include <tuple>
 #include <utility>
 
+#include "arena.hpp"
+
 namespace golos
 {
 
 using namespace ::eosio;
 
-template < typename T , typename... Ts >
-auto tuple_head( std::tuple<T,Ts...> t )
+/**
+ * @brief string_ref is a read-only view of a string argument inside the action data.
+ * It is valid until the action returns, the action copies it into a string only if it keeps the text.
+ * Serialized as a string, the ABI declares it as a string too (see process-abi.py).
+ */
+struct string_ref
 {
-   return  std::get<0>(t);
-}
+    const char *data = nullptr;
+    uint32_t size = 0;
 
-template < std::size_t... Ns , typename... Ts >
-auto tail_impl( std::index_sequence<Ns...> , std::tuple<Ts...> t )
-{
-   return  std::make_tuple( std::get<Ns+1u>(t)... );
-}
+    bool empty() const
+    {
+        return size == 0;
+    }
+
+    std::string str() const
+    {
+        return std::string(data, size);
+    }
+
+    operator std::string() const
+    {
+        return str();
+    }
 
-template < typename... Ts >
-auto tuple_tail( std::tuple<Ts...> t )
+    void print() const
+    {
+        prints_l(data, size);
+    }
+
+    template <typename DataStream>
+    friend DataStream &operator>>(DataStream &ds, string_ref &s)
+    {
+        unsigned_int size;
+        ds >> size;
+        eosio_assert(ds.remaining() >= size.value, "read");
+        s.data = ds.pos();
+        s.size = size.value;
+        ds.skip(s.size);
+        return ds;
+    }
+};
+
+// without the arena, payloads above this size don't fit the WASM stack and are read into a heap buffer
+constexpr size_t max_stack_buffer_size = 512;
+
+template <typename F, typename Tuple, std::size_t... Is>
+void apply_action_args(F &f, Tuple &args, std::index_sequence<Is...>)
 {
-   return  tail_impl( std::make_index_sequence<sizeof...(Ts) - 1u>() , t );
+    f(std::get<Is>(args)...);
 }
 
-template <typename T, typename Q, typename... Args>
-bool execute_app_action(uint64_t receiver, uint64_t code, void (Q::*func)(Args...))
+/**
+ * @brief with_action_args unpacks the action data in place and passes the arguments to f by reference.
+ * The data buffer lives until f returns, so string_ref arguments point into it.
+ * The action allocates from an arena sized from the action data until f returns (see arena.hpp),
+ * the buffer is taken from the arena too whatever the size. Without the arena, a buffer above
+ * max_stack_buffer_size takes a heap allocation
+ */
+template <typename... Args, typename F>
+void with_action_args(F &&f)
 {
     size_t size = action_data_size();
-    //using malloc/free here potentially is not exception-safe, although WASM doesn't support exceptions
-    constexpr size_t max_stack_buffer_size = 512;
-    void *buffer = nullptr;
+    arena_scope_t arena_scope(size);
+    //using new/delete here potentially is not exception-safe, although WASM doesn't support exceptions
+    char *buffer = nullptr;
+    bool heap_buffer = false;
     if (size > 0)
     {
-        buffer = max_stack_buffer_size < size ? malloc(size) : alloca(size);
+#if GOLOS_WORKER_ARENA
+        buffer = static_cast<char *>(action_arena().allocate(size));
+#else
+        heap_buffer = max_stack_buffer_size < size;
+        buffer = heap_buffer ? new char[size] : (char *)alloca(size);
+#endif
         read_action_data(buffer, size);
     }
 
-    auto args = unpack<std::tuple<std::decay_t<symbol_name> /* app domain */, std::decay_t<Args>... /* function args */>>((char *)buffer, size);
+    std::tuple<Args...> args;
+    datastream<const char *> ds(buffer, size);
+    ds >> args;
 
-    if (max_stack_buffer_size < size)
+    apply_action_args(f, args, std::index_sequence_for<Args...>());
+
+    if (heap_buffer)
     {
-        free(buffer);
+        delete[] buffer;
     }
+}
 
-    T obj(receiver, tuple_head(args));
-
-    auto f2 = [&](auto... a) {
-        (obj.*func)(a...);
-    };
+/**
+ * @brief peek_action_data copies the fixed-size head of the action data without unpacking the rest.
+ * The fields of T must be the leading fixed-size fields of the action, they are packed without padding.
+ * @return false if the action data is shorter than the head
+ */
+template <typename T>
+bool peek_action_data(T &head)
+{
+    if (action_data_size() < sizeof(T))
+    {
+        return false;
+    }
+    read_action_data(&head, sizeof(T));
+    return true;
+}
 
-    boost::mp11::tuple_apply(f2, tuple_tail(args));
+template <typename T, typename Q, typename... Args>
+bool execute_app_action(uint64_t receiver, uint64_t code, void (Q::*func)(Args...))
+{
+    with_action_args<symbol_name /* app domain */, std::decay_t<Args>... /* function args */>([&](symbol_name app_domain, auto &... args) {
+        T obj(receiver, app_domain);
+        (obj.*func)(args...);
+        // the rows kept by the action are written only when it has succeeded
+        obj.flush_rows();
+    });
     return true;
 }
 
@@ -67,40 +138,26 @@ bool execute_app_action(uint64_t receiver, uint64_t code, void (Q::*func)(Args..
 template <typename... Args>
 bool execute_action(uint64_t receiver, uint64_t code, void (*func)(uint64_t, Args...))
 {
-    size_t size = action_data_size();
-    //using malloc/free here potentially is not exception-safe, although WASM doesn't support exceptions
-    constexpr size_t max_stack_buffer_size = 512;
-    void *buffer = nullptr;
-    if (size > 0)
-    {
-        buffer = max_stack_buffer_size < size ? malloc(size) : alloca(size);
-        read_action_data(buffer, size);
-    }
-
-    auto args = unpack<std::tuple<std::decay_t<Args>... /* function args */>>((char *)buffer, size);
-
-    if (max_stack_buffer_size < size)
-    {
-        free(buffer);
-    }
-
-    auto f2 = [&](auto... a) {
-        (func)(code, a...);
-    };
-
-    boost::mp11::tuple_apply(f2, args);
+    with_action_args<std::decay_t<Args>... /* function args */>([&](auto &... args) {
+        (func)(code, args...);
+    });
     return true;
 }
 
 
+// every notification handler has an accept_ filter, it runs before the action data is unpacked
 #define ACTION_API_CALL(r, TYPENAME, elem)                          \
     case ::eosio::string_to_name(BOOST_PP_STRINGIZE(elem)):         \
-        ::golos::execute_action(receiver, code, TYPENAME::elem);         \
+        if (TYPENAME::BOOST_PP_CAT(accept_, elem)(receiver, code))  \
+        {                                                           \
+            ::golos::execute_action(receiver, code, TYPENAME::elem);     \
+        }                                                           \
         break;
 
 #define ACTIONS(TYPENAME, MEMBERS) \
     BOOST_PP_SEQ_FOR_EACH(ACTION_API_CALL, TYPENAME, MEMBERS)
 
+} // namespace golos
 
 
 /**
@@ -108,20 +165,30 @@ bool execute_action(uint64_t receiver, uint64_t code, void (*func)(uint64_t, Arg
  * However, the contract can use require_recipient to notify another account of the action so that a contract on that account may respond.
  * When it does this, it does not change the "code" account.
  */
-#define APP_DOMAIN_ABI(TYPENAME, APP_MEMBERS /* actions that expect app_domain argument */, MEMBERS /* actions that*/)           \
+#define APP_DOMAIN_ABI(TYPENAME, APP_MEMBERS /* actions that expect app_domain argument */, MEMBERS /* notifications from other contracts */) \
     extern "C"                                                                                                                   \
     {                                                                                                                            \
         void apply(uint64_t receiver, uint64_t code, uint64_t action)                                                            \
         {                                                                                                                        \
+            if (code != receiver)                                                                                                \
+            {                                                                                                                    \
+                switch (action)                                                                                                  \
+                {                                                                                                                \
+                    ACTIONS(TYPENAME, MEMBERS)                                                                                   \
+                                                                                                                                 \
+                    default:                                                                                                     \
+                    break;                                                                                                       \
+                }                                                                                                                \
+                return;                                                                                                          \
+            }                                                                                                                    \
+                                                                                                                                 \
             switch (action)                                                                                                      \
             {                                                                                                                    \
                 APP_ACTIONS(TYPENAME, APP_MEMBERS)                                                                               \
-                ACTIONS(TYPENAME, MEMBERS)                                                                                       \
                                                                                                                                  \
                 default:                                                                                                         \
                     eosio_assert(false, "invalid action");                                                                       \
                 break;                                                                                                           \
             }                                                                                                                    \
         }                                                                                                                        \
-    }                                                                                                                            \
-}
+    }
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// 1 - operator new takes the memory from a per-action arena (the wasm build, see ARENA in the Makefile),
+// 0 - the default heap (the native build, its tables outlive the action)
+#ifndef GOLOS_WORKER_ARENA
+#define GOLOS_WORKER_ARENA 0
+#endif
+
+namespace golos
+{
+
+/**
+ * @brief arena_t is a bump allocator: an allocation moves the offset in the current chunk and free does nothing.
+ * A request that doesn't fit the chunk takes a new one from malloc, the chunks are freed all together by release().
+ * The chunks are kept sorted by address, so owns() is a binary search however many chunks the arena has
+ */
+class arena_t
+{
+  struct alignas(std::max_align_t) chunk_t
+  {
+    size_t size;
+    size_t used;
+
+    char *data() { return reinterpret_cast<char *>(this + 1); }
+    const char *data() const { return reinterpret_cast<const char *>(this + 1); }
+  };
+
+  static constexpr size_t alignment = alignof(std::max_align_t);
+  static_assert(sizeof(chunk_t) % alignment == 0, "chunk data must be aligned");
+
+  chunk_t *_chunk = nullptr;
+  size_t _chunk_size;
+  // the chunks sorted by address, the array is taken from malloc like the chunks, not from operator new
+  chunk_t **_chunks = nullptr;
+  size_t _chunks_count = 0;
+  size_t _chunks_capacity = 0;
+
+  // index of the first chunk that starts after the pointer
+  size_t upper_bound(const void *ptr) const
+  {
+    size_t begin = 0;
+    size_t end = _chunks_count;
+    while (begin < end)
+    {
+      const size_t middle = begin + (end - begin) / 2;
+      if (static_cast<const void *>(_chunks[middle]) <= ptr)
+      {
+        begin = middle + 1;
+      }
+      else
+      {
+        end = middle;
+      }
+    }
+    return begin;
+  }
+
+  void add_chunk(size_t size)
+  {
+    if (_chunks_count == _chunks_capacity)
+    {
+      _chunks_capacity = std::max<size_t>(8, _chunks_capacity * 2);
+      _chunks = static_cast<chunk_t **>(realloc(_chunks, _chunks_capacity * sizeof(chunk_t *)));
+      if (_chunks == nullptr)
+      {
+        abort();
+      }
+    }
+
+    auto chunk = static_cast<chunk_t *>(malloc(sizeof(chunk_t) + size));
+    if (chunk == nullptr)
+    {
+      abort();
+    }
+    chunk->size = size;
+    chunk->used = 0;
+    _chunk = chunk;
+
+    const size_t position = upper_bound(chunk);
+    std::copy_backward(_chunks + position, _chunks + _chunks_count, _chunks + _chunks_count + 1);
+    _chunks[position] = chunk;
+    ++_chunks_count;
+  }
+
+public:
+  explicit arena_t(size_t chunk_size) : _chunk_size(chunk_size) {}
+  arena_t(const arena_t &) = delete;
+  arena_t &operator=(const arena_t &) = delete;
+
+  ~arena_t()
+  {
+    release();
+  }
+
+  void *allocate(size_t size)
+  {
+    size = (size + alignment - 1) & ~(alignment - 1);
+    if (_chunk == nullptr || _chunk->size - _chunk->used < size)
+    {
+      // the chunks grow twice like the vectors that overflow them, a large row gets room for the next allocations
+      if (_chunk != nullptr)
+      {
+        _chunk_size *= 2;
+      }
+      add_chunk(std::max(size + _chunk_size / 2, _chunk_size));
+    }
+    void *ptr = _chunk->data() + _chunk->used;
+    _chunk->used += size;
+    return ptr;
+  }
+
+  ///< true if the pointer is in one of the chunks
+  bool owns(const void *ptr) const
+  {
+    const size_t position = upper_bound(ptr);
+    if (position == 0)
+    {
+      return false;
+    }
+    const chunk_t *chunk = _chunks[position - 1];
+    const char *p = static_cast<const char *>(ptr);
+    return p >= chunk->data() && p < chunk->data() + chunk->size;
+  }
+
+  void set_chunk_size(size_t chunk_size)
+  {
+    _chunk_size = chunk_size;
+  }
+
+  void release()
+  {
+    for (size_t i = 0; i < _chunks_count; ++i)
+    {
+      free(_chunks[i]);
+    }
+    free(_chunks);
+    _chunks = nullptr;
+    _chunks_count = 0;
+    _chunks_capacity = 0;
+    _chunk = nullptr;
+  }
+
+  ///< number of the chunks taken from malloc
+  size_t chunks_count() const
+  {
+    return _chunks_count;
+  }
+};
+
+// the first chunk holds the action data, the unpacked arguments and the rows loaded by a typical action
+constexpr size_t arena_base_size = 16 * 1024;
+constexpr size_t arena_action_data_factor = 3;
+
+inline size_t arena_chunk_size(size_t action_data_size)
+{
+  return arena_base_size + arena_action_data_factor * action_data_size;
+}
+
+#if GOLOS_WORKER_ARENA
+
+// the chunks aren't released, the memory of the wasm instance is dropped after the action,
+// the arena is built in place to register no destructor
+inline arena_t &action_arena()
+{
+  alignas(arena_t) static char storage[sizeof(arena_t)];
+  static arena_t *arena = new (storage) arena_t(0);
+  return *arena;
+}
+
+inline bool &arena_active()
+{
+  static bool active = false;
+  return active;
+}
+
+/**
+ * @brief arena_scope_t makes operator new allocate from the action arena until the end of the scope.
+ * with_action_args() opens one for the action
+ */
+class arena_scope_t
+{
+public:
+  explicit arena_scope_t(size_t action_data_size)
+  {
+    action_arena().set_chunk_size(arena_chunk_size(action_data_size));
+    arena_active() = true;
+  }
+
+  ~arena_scope_t()
+  {
+    arena_active() = false;
+  }
+};
+
+#else
+
+class arena_scope_t
+{
+public:
+  explicit arena_scope_t(size_t) {}
+};
+
+#endif
+
+} // namespace golos
+
+#if GOLOS_WORKER_ARENA
+
+// the replacements of the global operators, the contract is a single translation unit
+void *operator new(size_t size)
+{
+  if (::golos::arena_active())
+  {
+    return ::golos::action_arena().allocate(size);
+  }
+  void *ptr = malloc(size);
+  if (ptr == nullptr)
+  {
+    abort();
+  }
+  return ptr;
+}
+
+void *operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+// the arena memory is dropped with the wasm instance, the blocks from malloc are freed
+// whenever they are deleted, in the scope or out of it
+void operator delete(void *ptr) noexcept
+{
+  if (ptr != nullptr && !::golos::action_arena().owns(ptr))
+  {
+    free(ptr);
+  }
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  operator delete(ptr);
+}
+
+// the sized and the nothrow forms go through the ones above, the size isn't needed to tell the arena blocks
+void operator delete(void *ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+// operator new aborts instead of returning null, the nothrow forms never see a failure
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+  return operator new(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+  operator delete(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+  operator delete(ptr);
+}
+
+#endif
@@ -0,0 +1,266 @@
+// Compares the per-action arena from arena.hpp with the default heap on the allocations of the contract
+// actions. The contract built natively records the operator new and delete calls of an action, then
+// the trace is replayed with malloc/free and with an arena_t sized like in the wasm build. The stand-in
+// tables allocate their rows like the item cache of multi_index does, the wasm heap is eosiolib's
+// memory manager, not malloc of the host, so the times compare the allocators and not the actions.
+
+#include "harness.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+struct event_t
+{
+    ///< index of the allocation in the trace
+    uint32_t block;
+    ///< size of the allocation, 0 for a delete
+    uint32_t size;
+};
+
+// a header before every block keeps the trace and the index of the allocation in it
+struct header_t
+{
+    uint32_t trace;
+    uint32_t block;
+};
+constexpr size_t header_size = alignof(std::max_align_t);
+static_assert(sizeof(header_t) <= header_size, "header doesn't fit");
+
+bool tracing = false;
+// 0 for the blocks allocated out of the traces
+uint32_t trace_id = 0;
+uint32_t traced_blocks = 0;
+vector<event_t> *trace = nullptr;
+
+struct traced_action_t
+{
+    const char *label;
+    size_t action_data_size;
+    vector<event_t> events;
+    uint32_t blocks;
+};
+
+} // namespace
+
+void *operator new(size_t size)
+{
+    char *ptr = static_cast<char *>(malloc(size + header_size));
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    header_t header{0, 0};
+    if (tracing)
+    {
+        header = header_t{trace_id, traced_blocks++};
+        trace->push_back(event_t{header.block, uint32_t(std::max<size_t>(size, 1))});
+    }
+    *reinterpret_cast<header_t *>(ptr) = header;
+    return ptr + header_size;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    char *block_ptr = static_cast<char *>(ptr) - header_size;
+    // the blocks of the previous actions are deleted by the stand-in tables, not by the traced action
+    const header_t header = *reinterpret_cast<header_t *>(block_ptr);
+    if (tracing && header.trace == trace_id)
+    {
+        trace->push_back(event_t{header.block, 0});
+    }
+    free(block_ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+namespace
+{
+
+const size_t replay_rounds = 1000;
+const size_t max_trace_events = 1 << 20;
+
+// runs the call and records its allocations
+traced_action_t traced(const char *label, const call_t &call)
+{
+    traced_action_t action{label, call.data.size(), {}, 0};
+    action.events.reserve(max_trace_events);
+
+    trace = &action.events;
+    ++trace_id;
+    traced_blocks = 0;
+    tracing = true;
+    run(call);
+    tracing = false;
+    trace = nullptr;
+
+    eosio_assert(action.events.size() < max_trace_events, "trace is too long");
+    action.blocks = traced_blocks;
+    return action;
+}
+
+double replay_heap(const traced_action_t &action, vector<void *> &blocks)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < replay_rounds; ++round)
+    {
+        for (const auto &event : action.events)
+        {
+            if (event.size)
+            {
+                blocks[event.block] = malloc(event.size);
+            }
+            else
+            {
+                free(blocks[event.block]);
+                blocks[event.block] = nullptr;
+            }
+        }
+        // the blocks left by the action are dropped with the wasm memory
+        for (auto &block : blocks)
+        {
+            free(block);
+            block = nullptr;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / replay_rounds;
+}
+
+double replay_arena(const traced_action_t &action, vector<void *> &blocks, size_t &chunks)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < replay_rounds; ++round)
+    {
+        golos::arena_t arena(golos::arena_chunk_size(action.action_data_size));
+        for (const auto &event : action.events)
+        {
+            if (event.size)
+            {
+                blocks[event.block] = arena.allocate(event.size);
+            }
+            else
+            {
+                eosio_assert(arena.owns(blocks[event.block]), "block isn't in the arena");
+            }
+        }
+        chunks = arena.chunks_count();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / replay_rounds;
+}
+
+void report(const traced_action_t &action)
+{
+    size_t allocations = 0;
+    size_t bytes = 0;
+    for (const auto &event : action.events)
+    {
+        allocations += event.size != 0;
+        bytes += event.size;
+    }
+
+    vector<void *> blocks(action.blocks, nullptr);
+    const double heap_ns = replay_heap(action, blocks);
+    size_t chunks = 0;
+    const double arena_ns = replay_arena(action, blocks, chunks);
+
+    printf("%-14s %8zu %8zu %10zu %10zu %8zu %12.1f %12.1f\n", action.label, action.action_data_size, allocations,
+           action.events.size() - allocations, bytes, chunks, heap_ns, arena_ns);
+}
+
+} // namespace
+
+int main()
+{
+    native::now = 1500000000;
+
+    const account_name app = make_account("golos", 0);
+    const auto delegates = make_accounts("delegate", witness_count);
+    const auto members = make_accounts("member", witness_count);
+    const account_name author = members[0];
+    const account_name tspec_author = members[1];
+    const account_name worker_account = members[2];
+    const golos::proposal_id_t proposal_id = 0;
+
+    vector<traced_action_t> actions;
+    try
+    {
+        give_stake({app}, 1000000);
+        give_stake(delegates, 1000000);
+        give_stake(members, 1000000);
+
+        run(app_call(N(createpool), app, app, token_symbol, uint8_t(golos::state_t::COMMENTS_STORED)));
+        run(app_call(N(setdelegates), app, app, delegates));
+        run(transfer_call(app, app, 10000000));
+
+        actions.push_back(traced("addpropos", app_call(N(addpropos), author, app, proposal_id, author, std::string(128, 't'),
+                                                       std::string(2048, 'd'))));
+        for (golos::comment_id_t comment_id = 0; comment_id < 10; ++comment_id)
+        {
+            run(app_call(N(addcomment), members[comment_id], app, proposal_id, comment_id, members[comment_id],
+                         make_comment("Let's do it!")));
+        }
+        actions.push_back(traced("addcomment", app_call(N(addcomment), author, app, proposal_id, golos::comment_id_t(10), author,
+                                                        make_comment("Let's do it!"))));
+        for (size_t i = 1; i < members.size(); ++i)
+        {
+            run(app_call(N(votepropos), members[i], app, proposal_id, members[i], uint8_t(i % 2)));
+        }
+        actions.push_back(traced("votepropos", app_call(N(votepropos), author, app, proposal_id, author, uint8_t(1))));
+
+        for (golos::tspec_id_t tspec_id = 1; tspec_id < 10; ++tspec_id)
+        {
+            run(app_call(N(addtspec), members[tspec_id], app, proposal_id, tspec_id, members[tspec_id], make_tspec(tspec_id, 1024)));
+        }
+        actions.push_back(traced("addtspec", app_call(N(addtspec), tspec_author, app, proposal_id, golos::tspec_id_t(0), tspec_author,
+                                                      make_tspec(0, 1024))));
+
+        for (size_t i = 0; i + 1 < witness_count_51; ++i)
+        {
+            run(app_call(N(votetspec), delegates[i], app, proposal_id, golos::tspec_id_t(0), delegates[i], uint8_t(1),
+                         golos::comment_id_t(i), make_comment("I agree")));
+        }
+        const size_t last = witness_count_51 - 1;
+        actions.push_back(traced("votetspec", app_call(N(votetspec), delegates[last], app, proposal_id, golos::tspec_id_t(0),
+                                                       delegates[last], uint8_t(1), golos::comment_id_t(last),
+                                                       make_comment("I agree"))));
+
+        actions.push_back(traced("startwork", app_call(N(startwork), tspec_author, app, proposal_id, worker_account)));
+        actions.push_back(traced("poststatus", app_call(N(poststatus), worker_account, app, proposal_id, golos::comment_id_t(0),
+                                                        make_comment("Work is done"), true)));
+        run(app_call(N(acceptwork), tspec_author, app, proposal_id, golos::comment_id_t(1), make_comment("All work done well")));
+        for (size_t i = 0; i + 1 < witness_count_51; ++i)
+        {
+            run(app_call(N(reviewwork), delegates[i], app, proposal_id, delegates[i], uint8_t(1), golos::comment_id_t(2 + i),
+                         make_comment("Lorem ipsum dolor sit am")));
+        }
+        actions.push_back(traced("reviewwork", app_call(N(reviewwork), delegates[last], app, proposal_id, delegates[last],
+                                                        uint8_t(1), golos::comment_id_t(2 + last),
+                                                        make_comment("Lorem ipsum dolor sit am"))));
+        actions.push_back(traced("withdraw", app_call(N(withdraw), worker_account, app, proposal_id)));
+    }
+    catch (const native::assert_error &e)
+    {
+        fprintf(stderr, "assertion failed: %s\n", e.what());
+        return 1;
+    }
+
+    printf("%-14s %8s %8s %10s %10s %8s %12s %12s\n", "action", "data", "allocs", "deletes", "bytes", "chunks",
+           "heap ns", "arena ns");
+    for (const auto &action : actions)
+    {
+        report(action);
+    }
+
+    return 0;
+}
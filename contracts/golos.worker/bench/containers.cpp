@@ -0,0 +1,185 @@
+// Compares the legacy unsorted set_t with the sorted one from structs.hpp
+// at the sizes we see on chain: 21 delegates, 1k and 10k members/comments.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "../structs.hpp"
+
+namespace
+{
+
+using golos::set_t;
+using std::vector;
+
+template <typename T>
+class legacy_set_t : public vector<T>
+{
+  public:
+    using vector<T>::end;
+    using vector<T>::begin;
+    using vector<T>::erase;
+    using vector<T>::push_back;
+
+    bool has(const T &v) const
+    {
+        return std::find(begin(), end(), v) != end();
+    }
+
+    void set(const T &v)
+    {
+        push_back(v);
+    }
+
+    bool unset(const T &v)
+    {
+        auto i = std::find(begin(), end(), v);
+        if (i != end())
+        {
+            erase(i);
+            return true;
+        }
+        return false;
+    }
+};
+
+struct comment_t
+{
+    uint64_t id;
+    uint64_t author;
+    std::string text;
+
+    friend bool operator<(const comment_t &a, const comment_t &b) { return a.id < b.id; }
+    friend bool operator<(const comment_t &a, uint64_t id) { return a.id < id; }
+    friend bool operator<(uint64_t id, const comment_t &b) { return id < b.id; }
+};
+
+template <typename F>
+double measure_ns(size_t ops, F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+volatile uint64_t sink;
+
+template <typename Set>
+void bench_set(const char *name, const vector<uint64_t> &keys, const vector<uint64_t> &probes)
+{
+    // small sets are rebuilt several times to get stable numbers
+    const size_t rounds = std::max<size_t>(1, 100000 / keys.size());
+    double insert_ns = 0, unset_ns = 0, has_ns = 0;
+
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        Set set;
+        insert_ns += measure_ns(keys.size() * rounds, [&] {
+            for (auto key : keys)
+            {
+                if (!set.has(key))
+                {
+                    set.set(key);
+                }
+            }
+        });
+
+        if (round == 0)
+        {
+            has_ns = measure_ns(probes.size(), [&] {
+                uint64_t found = 0;
+                for (auto key : probes)
+                {
+                    found += set.has(key);
+                }
+                sink = found;
+            });
+        }
+
+        unset_ns += measure_ns(keys.size() * rounds, [&] {
+            for (auto key : keys)
+            {
+                set.unset(key);
+            }
+        });
+    }
+
+    printf("%-14s %8zu %14.1f %14.1f %14.1f\n", name, keys.size(), insert_ns, has_ns, unset_ns);
+}
+
+void bench_comments(size_t count, std::mt19937_64 &rng)
+{
+    vector<comment_t> legacy;
+    set_t<comment_t> sorted;
+    for (uint64_t id = 0; id < count; ++id)
+    {
+        comment_t comment{id, rng(), "comment"};
+        legacy.push_back(comment);
+        sorted.set(comment);
+    }
+
+    const size_t lookups = 100000;
+    vector<uint64_t> ids(lookups);
+    for (auto &id : ids)
+    {
+        id = rng() % count;
+    }
+
+    const double legacy_ns = measure_ns(lookups, [&] {
+        uint64_t authors = 0;
+        for (auto id : ids)
+        {
+            authors += std::find_if(legacy.begin(), legacy.end(), [&](const comment_t &c) { return c.id == id; })->author;
+        }
+        sink = authors;
+    });
+
+    const double sorted_ns = measure_ns(lookups, [&] {
+        uint64_t authors = 0;
+        for (auto id : ids)
+        {
+            authors += sorted.find(id)->author;
+        }
+        sink = authors;
+    });
+
+    printf("%-14s %8zu %14.1f %14.1f\n", "comment lookup", count, legacy_ns, sorted_ns);
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(42);
+
+    printf("%-14s %8s %14s %14s %14s\n", "container", "size", "set ns/op", "has ns/op", "unset ns/op");
+    for (size_t size : {21, 1000, 10000})
+    {
+        vector<uint64_t> keys(size);
+        for (auto &key : keys)
+        {
+            key = rng();
+        }
+
+        vector<uint64_t> probes;
+        for (size_t i = 0; i < 100000; ++i)
+        {
+            probes.push_back(i % 2 ? keys[rng() % size] : rng());
+        }
+
+        bench_set<legacy_set_t<uint64_t>>("legacy set_t", keys, probes);
+        bench_set<set_t<uint64_t>>("sorted set_t", keys, probes);
+    }
+
+    printf("\n%-14s %8s %14s %14s\n", "container", "size", "legacy ns/op", "sorted ns/op");
+    for (size_t size : {21, 1000, 10000})
+    {
+        bench_comments(size, rng);
+    }
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "eosio.hpp"
+
+namespace eosio
+{
+
+struct permission_level
+{
+    account_name actor;
+    permission_name permission;
+
+    EOSLIB_SERIALIZE(permission_level, (actor)(permission))
+};
+
+/**
+ * @brief action packs the arguments like the chain does, send() records the action in native::sent_actions
+ */
+struct action
+{
+    account_name account;
+    action_name name;
+    std::vector<permission_level> authorization;
+    std::vector<char> data;
+
+    EOSLIB_SERIALIZE(action, (account)(name)(authorization)(data))
+
+    template <typename T>
+    action(const permission_level &auth, account_name a, action_name n, T &&value)
+        : account(a), name(n), authorization{auth}, data(pack(std::forward<T>(value)))
+    {
+    }
+
+    // the chain fails the transaction when the packed action is above the limit
+    void send() const
+    {
+        eosio_assert(pack(*this).size() <= native::max_inline_action_size, "inline action is too big");
+        native::sent_actions.push_back(native::sent_action_t{account, name, data});
+    }
+};
+
+} // namespace eosio
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "eosio.hpp"
+
+namespace eosio
+{
+
+struct currency
+{
+    struct transfer
+    {
+        account_name from;
+        account_name to;
+        asset quantity;
+        std::string memo;
+
+        EOSLIB_SERIALIZE(transfer, (from)(to)(quantity)(memo))
+    };
+};
+
+} // namespace eosio
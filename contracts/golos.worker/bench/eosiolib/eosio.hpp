@@ -0,0 +1,963 @@
+// In-memory stand-in for the parts of eosiolib that main.cpp uses, so the contract
+// can be built and benchmarked natively. Tables live in process memory and rows are
+// packed only to account their size, intrinsics keep their state in eosio::native.
+#pragma once
+
+#include <alloca.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/preprocessor/seq/for_each.hpp>
+#include <boost/preprocessor/stringize.hpp>
+
+typedef uint64_t account_name;
+typedef uint64_t permission_name;
+typedef uint64_t table_name;
+typedef uint64_t action_name;
+typedef uint64_t scope_name;
+typedef uint64_t symbol_name;
+typedef unsigned __int128 uint128_t;
+
+namespace eosio
+{
+
+/**
+ * @brief native keeps the state of the intrinsics: the action data, the current time,
+ * the authorizations of the action and the inline actions it has sent
+ */
+namespace native
+{
+struct sent_action_t
+{
+    account_name account;
+    action_name name;
+    std::vector<char> data;
+};
+
+inline const char *action_data = nullptr;
+inline uint32_t action_data_size = 0;
+inline std::set<account_name> authorizations;
+inline account_name receiver = 0;
+inline uint32_t now = 0;
+inline std::vector<sent_action_t> sent_actions;
+// the default max_inline_action_size of the chain, bounds the packed inline action
+inline size_t max_inline_action_size = 4096;
+// the console of the current action, run() clears it like the chain keeps one per action trace
+inline std::string output;
+
+struct assert_error : std::runtime_error
+{
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief db_stats_t counts the database intrinsics the tables would call on chain:
+ * a find is a lookup or a step of an iterator, a read loads and unpacks a row,
+ * an update, a store or a remove packs or frees it
+ */
+struct db_stats_t
+{
+    uint64_t finds = 0;
+    uint64_t reads = 0;
+    uint64_t updates = 0;
+    uint64_t stores = 0;
+    uint64_t removes = 0;
+    uint64_t bytes_read = 0;
+    uint64_t bytes_written = 0;
+    std::map<account_name, int64_t> ram_delta;
+};
+
+// billable sizes of a primary row and of a secondary index row besides the packed data
+const int64_t row_overhead = 112;
+const int64_t index_row_overhead = 128;
+
+inline db_stats_t db_stats;
+} // namespace native
+
+} // namespace eosio
+
+inline void eosio_assert(uint32_t test, const char *msg)
+{
+    if (!test)
+    {
+        throw eosio::native::assert_error(msg);
+    }
+}
+
+inline bool has_auth(account_name name)
+{
+    return eosio::native::authorizations.count(name);
+}
+
+inline void require_auth(account_name name)
+{
+    eosio_assert(has_auth(name), "missing authority");
+}
+
+namespace eosio
+{
+namespace native
+{
+// the chain bills more RAM to an account other than the receiver only if it has authorized the action
+inline void require_ram_payer(account_name payer, int64_t delta)
+{
+    eosio_assert(delta <= 0 || payer == receiver || has_auth(payer),
+                 "unauthorized RAM usage increase: the payer hasn't authorized the action");
+}
+} // namespace native
+} // namespace eosio
+
+inline uint32_t now()
+{
+    return eosio::native::now;
+}
+
+inline account_name current_receiver()
+{
+    return eosio::native::receiver;
+}
+
+inline uint32_t action_data_size()
+{
+    return eosio::native::action_data_size;
+}
+
+inline uint32_t read_action_data(void *msg, uint32_t len)
+{
+    len = std::min<uint32_t>(len, eosio::native::action_data_size);
+    memcpy(msg, eosio::native::action_data, len);
+    return len;
+}
+
+inline void prints_l(const char *cstr, uint32_t len)
+{
+    eosio::native::output.append(cstr, len);
+}
+
+inline void prints(const char *cstr)
+{
+    eosio::native::output.append(cstr);
+}
+
+namespace eosio
+{
+
+static constexpr char char_to_symbol(char c)
+{
+    if (c >= 'a' && c <= 'z')
+        return (c - 'a') + 6;
+    if (c >= '1' && c <= '5')
+        return (c - '1') + 1;
+    return 0;
+}
+
+static constexpr uint64_t string_to_name(const char *str)
+{
+    uint32_t len = 0;
+    while (str[len])
+        ++len;
+
+    uint64_t value = 0;
+    for (uint32_t i = 0; i <= 12; ++i)
+    {
+        uint64_t c = 0;
+        if (i < len)
+            c = uint64_t(char_to_symbol(str[i]));
+
+        if (i < 12)
+        {
+            c &= 0x1f;
+            c <<= 64 - 5 * (i + 1);
+        }
+        else
+        {
+            c &= 0x0f;
+        }
+        value |= c;
+    }
+    return value;
+}
+
+#define N(X) ::eosio::string_to_name(#X)
+
+struct name
+{
+    account_name value = 0;
+
+    std::string to_string() const
+    {
+        static const char *charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+        std::string str(13, '.');
+        uint64_t tmp = value;
+        for (uint32_t i = 0; i <= 12; ++i)
+        {
+            char c = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
+            str[12 - i] = c;
+            tmp >>= (i == 0 ? 4 : 5);
+        }
+
+        const auto last = str.find_last_not_of('.');
+        str.resize(last == std::string::npos ? 0 : last + 1);
+        return str;
+    }
+};
+
+// printing
+
+inline void print(const char *s) { prints(s); }
+inline void print(const std::string &s) { prints_l(s.data(), s.size()); }
+inline void print(char c) { prints_l(&c, 1); }
+
+template <typename T, std::enable_if_t<std::is_integral<T>::value, int> = 0>
+void print(T value)
+{
+    print(std::to_string(value));
+}
+
+template <typename T, std::enable_if_t<std::is_class<T>::value, int> = 0>
+void print(const T &t)
+{
+    t.print();
+}
+
+inline void print_f(const char *s)
+{
+    prints(s);
+}
+
+template <typename Arg, typename... Args>
+void print_f(const char *s, Arg val, Args... rest)
+{
+    while (*s != '\0')
+    {
+        if (*s == '%')
+        {
+            print(val);
+            print_f(s + 1, rest...);
+            return;
+        }
+        prints_l(s, 1);
+        s++;
+    }
+}
+
+// serialization
+
+template <typename T>
+class datastream
+{
+  public:
+    datastream(T start, size_t s) : _start(start), _pos(start), _end(start + s) {}
+
+    void skip(size_t s) { _pos += s; }
+
+    bool read(char *d, size_t s)
+    {
+        eosio_assert(size_t(_end - _pos) >= s, "read");
+        memcpy(d, _pos, s);
+        _pos += s;
+        return true;
+    }
+
+    bool write(const char *d, size_t s)
+    {
+        eosio_assert(_end - _pos >= (int32_t)s, "write");
+        memcpy((void *)_pos, d, s);
+        _pos += s;
+        return true;
+    }
+
+    T pos() const { return _pos; }
+    size_t tellp() const { return _pos - _start; }
+    size_t remaining() const { return _end - _pos; }
+
+  private:
+    T _start;
+    T _pos;
+    T _end;
+};
+
+template <>
+class datastream<size_t>
+{
+  public:
+    datastream(size_t init_size = 0) : _size(init_size) {}
+
+    bool skip(size_t s)
+    {
+        _size += s;
+        return true;
+    }
+
+    bool write(const char *, size_t s)
+    {
+        _size += s;
+        return true;
+    }
+
+    size_t tellp() const { return _size; }
+    size_t remaining() const { return 0; }
+
+  private:
+    size_t _size;
+};
+
+struct unsigned_int
+{
+    unsigned_int(uint32_t v = 0) : value(v) {}
+
+    uint32_t value;
+
+    template <typename DataStream>
+    friend DataStream &operator<<(DataStream &ds, const unsigned_int &v)
+    {
+        uint64_t val = v.value;
+        do
+        {
+            uint8_t b = uint8_t(val) & 0x7f;
+            val >>= 7;
+            b |= ((val > 0) << 7);
+            ds.write((char *)&b, 1);
+        } while (val);
+        return ds;
+    }
+
+    template <typename DataStream>
+    friend DataStream &operator>>(DataStream &ds, unsigned_int &vi)
+    {
+        uint64_t v = 0;
+        char b = 0;
+        uint8_t by = 0;
+        do
+        {
+            ds.read(&b, 1);
+            v |= uint32_t(uint8_t(b) & 0x7f) << by;
+            by += 7;
+        } while (uint8_t(b) & 0x80);
+        vi.value = static_cast<uint32_t>(v);
+        return ds;
+    }
+};
+
+template <typename DataStream, typename T, std::enable_if_t<std::is_arithmetic<T>::value || std::is_same<T, uint128_t>::value, int> = 0>
+DataStream &operator<<(DataStream &ds, const T &v)
+{
+    ds.write((const char *)&v, sizeof(T));
+    return ds;
+}
+
+template <typename DataStream, typename T, std::enable_if_t<std::is_arithmetic<T>::value || std::is_same<T, uint128_t>::value, int> = 0>
+DataStream &operator>>(DataStream &ds, T &v)
+{
+    ds.read((char *)&v, sizeof(T));
+    return ds;
+}
+
+template <typename DataStream>
+DataStream &operator<<(DataStream &ds, const std::string &v)
+{
+    ds << unsigned_int(v.size());
+    if (v.size())
+        ds.write(v.data(), v.size());
+    return ds;
+}
+
+template <typename DataStream>
+DataStream &operator>>(DataStream &ds, std::string &v)
+{
+    unsigned_int s;
+    ds >> s;
+    v.resize(s.value);
+    if (s.value)
+        ds.read(&v[0], s.value);
+    return ds;
+}
+
+template <typename DataStream, typename T>
+DataStream &operator<<(DataStream &ds, const std::vector<T> &v)
+{
+    ds << unsigned_int(v.size());
+    for (const auto &i : v)
+        ds << i;
+    return ds;
+}
+
+template <typename DataStream, typename T>
+DataStream &operator>>(DataStream &ds, std::vector<T> &v)
+{
+    unsigned_int s;
+    ds >> s;
+    v.resize(s.value);
+    for (auto &i : v)
+        ds >> i;
+    return ds;
+}
+
+template <typename DataStream, typename... Args>
+DataStream &operator<<(DataStream &ds, const std::tuple<Args...> &t)
+{
+    std::apply([&](const auto &... args) { ((ds << args), ...); }, t);
+    return ds;
+}
+
+template <typename DataStream, typename... Args>
+DataStream &operator>>(DataStream &ds, std::tuple<Args...> &t)
+{
+    std::apply([&](auto &... args) { ((ds >> args), ...); }, t);
+    return ds;
+}
+
+#define EOSLIB_REFLECT_MEMBER_OP(r, OP, elem) \
+    OP t.elem
+
+#define EOSLIB_SERIALIZE(TYPE, MEMBERS)                                     \
+    template <typename DataStream>                                          \
+    friend DataStream &operator<<(DataStream &ds, const TYPE &t)            \
+    {                                                                       \
+        return ds BOOST_PP_SEQ_FOR_EACH(EOSLIB_REFLECT_MEMBER_OP, <<, MEMBERS); \
+    }                                                                       \
+    template <typename DataStream>                                          \
+    friend DataStream &operator>>(DataStream &ds, TYPE &t)                  \
+    {                                                                       \
+        return ds BOOST_PP_SEQ_FOR_EACH(EOSLIB_REFLECT_MEMBER_OP, >>, MEMBERS); \
+    }
+
+template <typename T>
+size_t pack_size(const T &value)
+{
+    datastream<size_t> size_ds;
+    size_ds << value;
+    return size_ds.tellp();
+}
+
+template <typename T>
+std::vector<char> pack(const T &value)
+{
+    std::vector<char> result(pack_size(value));
+    datastream<char *> ds(result.data(), result.size());
+    ds << value;
+    return result;
+}
+
+// assets
+
+static constexpr uint64_t string_to_symbol(uint8_t precision, const char *str)
+{
+    uint32_t len = 0;
+    while (str[len])
+        ++len;
+
+    uint64_t result = 0;
+    for (uint32_t i = 0; i < len; ++i)
+    {
+        result |= (uint64_t(str[i]) << (8 * (1 + i)));
+    }
+
+    result |= uint64_t(precision);
+    return result;
+}
+
+#define S(P, X) ::eosio::string_to_symbol(P, #X)
+
+struct symbol_type
+{
+    symbol_name value;
+
+    symbol_type() {}
+    symbol_type(symbol_name s) : value(s) {}
+
+    bool is_valid() const
+    {
+        auto sym = value >> 8;
+        for (int i = 0; i < 7; ++i)
+        {
+            char c = (char)(sym & 0xff);
+            if (!('A' <= c && c <= 'Z'))
+                return false;
+            sym >>= 8;
+            if (!(sym & 0xff))
+            {
+                do
+                {
+                    sym >>= 8;
+                    if ((sym & 0xff))
+                        return false;
+                    ++i;
+                } while (i < 7);
+            }
+        }
+        return true;
+    }
+
+    symbol_name name() const { return value >> 8; }
+
+    operator symbol_name() const { return value; }
+
+    void print() const
+    {
+        auto sym = value >> 8;
+        while (sym & 0xff)
+        {
+            char c = char(sym & 0xff);
+            prints_l(&c, 1);
+            sym >>= 8;
+        }
+    }
+
+    EOSLIB_SERIALIZE(symbol_type, (value))
+};
+
+struct asset
+{
+    static constexpr int64_t max_amount = (1LL << 62) - 1;
+
+    int64_t amount;
+    symbol_type symbol;
+
+    explicit asset(int64_t a = 0, symbol_type s = S(4, SYS)) : amount(a), symbol{s} {}
+
+    bool is_amount_within_range() const { return -max_amount <= amount && amount <= max_amount; }
+    bool is_valid() const { return is_amount_within_range() && symbol.is_valid(); }
+
+    asset operator-() const { return asset(-amount, symbol); }
+
+    asset &operator-=(const asset &a)
+    {
+        eosio_assert(a.symbol == symbol, "attempt to subtract asset with different symbol");
+        amount -= a.amount;
+        return *this;
+    }
+
+    asset &operator+=(const asset &a)
+    {
+        eosio_assert(a.symbol == symbol, "attempt to add asset with different symbol");
+        amount += a.amount;
+        return *this;
+    }
+
+    friend asset operator+(const asset &a, const asset &b)
+    {
+        asset result = a;
+        result += b;
+        return result;
+    }
+
+    friend asset operator-(const asset &a, const asset &b)
+    {
+        asset result = a;
+        result -= b;
+        return result;
+    }
+
+    friend asset operator/(const asset &a, int64_t b)
+    {
+        eosio_assert(b != 0, "divide by zero");
+        return asset(a.amount / b, a.symbol);
+    }
+
+    friend bool operator==(const asset &a, const asset &b) { return a.symbol == b.symbol && a.amount == b.amount; }
+    friend bool operator!=(const asset &a, const asset &b) { return !(a == b); }
+
+    friend bool operator<(const asset &a, const asset &b)
+    {
+        eosio_assert(a.symbol == b.symbol, "comparison of assets with different symbols is not allowed");
+        return a.amount < b.amount;
+    }
+
+    friend bool operator<=(const asset &a, const asset &b) { return !(b < a); }
+    friend bool operator>(const asset &a, const asset &b) { return b < a; }
+    friend bool operator>=(const asset &a, const asset &b) { return !(a < b); }
+
+    void print() const
+    {
+        eosio::print(amount);
+        prints(" ");
+        symbol.print();
+    }
+
+    EOSLIB_SERIALIZE(asset, (amount)(symbol))
+};
+
+// hashes
+
+struct checksum256
+{
+    uint8_t hash[32];
+
+    template <typename DataStream>
+    friend DataStream &operator<<(DataStream &ds, const checksum256 &d)
+    {
+        ds.write((const char *)d.hash, sizeof(d.hash));
+        return ds;
+    }
+
+    template <typename DataStream>
+    friend DataStream &operator>>(DataStream &ds, checksum256 &d)
+    {
+        ds.read((char *)d.hash, sizeof(d.hash));
+        return ds;
+    }
+};
+
+// contracts
+
+class contract
+{
+  public:
+    contract(account_name n) : _self(n) {}
+
+    account_name get_self() const { return _self; }
+
+  protected:
+    account_name _self;
+};
+
+// tables
+
+struct key256
+{
+    std::array<uint64_t, 4> words;
+
+    template <typename Word, typename... Words>
+    static key256 make_from_word_sequence(Word first, Words... rest)
+    {
+        return key256{{{uint64_t(first), uint64_t(rest)...}}};
+    }
+
+    friend bool operator<(const key256 &a, const key256 &b) { return a.words < b.words; }
+    friend bool operator==(const key256 &a, const key256 &b) { return a.words == b.words; }
+};
+
+template <class Class, typename Type, Type (Class::*PtrToMemberFunction)() const>
+struct const_mem_fun
+{
+    typedef typename std::remove_reference<Type>::type result_type;
+
+    Type operator()(const Class &x) const { return (x.*PtrToMemberFunction)(); }
+};
+
+template <uint64_t IndexName, typename Extractor>
+struct indexed_by
+{
+    static constexpr uint64_t index_name = IndexName;
+    typedef Extractor extractor_type;
+    typedef typename Extractor::result_type key_type;
+};
+
+/**
+ * @brief multi_index keeps the rows in a map by primary key and every secondary index
+ * in a set of (secondary key, primary key) pairs, like the chain orders them. Every row
+ * remembers its payer and packed size to account the database operations in native::db_stats
+ */
+template <uint64_t TableName, typename T, typename... Indices>
+class multi_index
+{
+    template <typename Index>
+    using index_set_t = std::set<std::pair<typename Index::key_type, uint64_t>>;
+
+    struct row_t
+    {
+        T value;
+        account_name payer;
+        int64_t size;
+    };
+
+    typedef std::map<uint64_t, row_t> rows_t;
+
+    struct table_t
+    {
+        rows_t rows;
+        std::tuple<index_set_t<Indices>...> indices;
+    };
+
+    static constexpr int64_t billable_overhead = native::row_overhead + native::index_row_overhead * sizeof...(Indices);
+
+    static std::map<std::pair<uint64_t, uint64_t>, table_t> &tables()
+    {
+        static std::map<std::pair<uint64_t, uint64_t>, table_t> instances;
+        return instances;
+    }
+
+    table_t &_table;
+
+    // a lookup that loads the row it has found
+    static void account_find(const table_t &table, typename rows_t::const_iterator itr)
+    {
+        ++native::db_stats.finds;
+        if (itr != table.rows.end())
+        {
+            ++native::db_stats.reads;
+            native::db_stats.bytes_read += itr->second.size;
+        }
+    }
+
+    static void account_ram(account_name payer, int64_t delta)
+    {
+        native::db_stats.ram_delta[payer] += delta;
+    }
+
+    template <size_t... Is>
+    void index_row(const T &row, bool insert, std::index_sequence<Is...>)
+    {
+        (index_row_in<Is>(row, insert), ...);
+    }
+
+    template <size_t I>
+    void index_row_in(const T &row, bool insert)
+    {
+        typedef typename std::tuple_element<I, std::tuple<Indices...>>::type index_t;
+        auto key = std::make_pair(typename index_t::extractor_type()(row), row.primary_key());
+        if (insert)
+            std::get<I>(_table.indices).insert(key);
+        else
+            std::get<I>(_table.indices).erase(key);
+    }
+
+    void index_row(const T &row, bool insert)
+    {
+        index_row(row, insert, std::index_sequence_for<Indices...>());
+    }
+
+    template <uint64_t IndexName, size_t I = 0>
+    static constexpr size_t index_position()
+    {
+        static_assert(I < sizeof...(Indices), "unknown index");
+        if constexpr (std::tuple_element<I, std::tuple<Indices...>>::type::index_name == IndexName)
+            return I;
+        else
+            return index_position<IndexName, I + 1>();
+    }
+
+    typename rows_t::iterator erase_row(typename rows_t::const_iterator itr)
+    {
+        ++native::db_stats.removes;
+        account_ram(itr->second.payer, -(itr->second.size + billable_overhead));
+        index_row(itr->second.value, false);
+        return _table.rows.erase(itr);
+    }
+
+  public:
+    class const_iterator
+    {
+        friend class multi_index;
+
+        const table_t *_table;
+        typename rows_t::const_iterator _itr;
+
+      public:
+        const_iterator(const table_t *table, typename rows_t::const_iterator itr) : _table(table), _itr(itr) {}
+
+        const T &operator*() const { return _itr->second.value; }
+        const T *operator->() const { return &_itr->second.value; }
+
+        const_iterator &operator++()
+        {
+            ++_itr;
+            account_find(*_table, _itr);
+            return *this;
+        }
+
+        friend bool operator==(const const_iterator &a, const const_iterator &b) { return a._itr == b._itr; }
+        friend bool operator!=(const const_iterator &a, const const_iterator &b) { return a._itr != b._itr; }
+    };
+
+    multi_index(uint64_t code, uint64_t scope) : _table(tables()[std::make_pair(code, scope)]) {}
+
+    static void clear_all() { tables().clear(); }
+
+    const_iterator begin() const { return lower_bound(0); }
+    const_iterator end() const { return const_iterator(&_table, _table.rows.end()); }
+
+    const_iterator find(uint64_t primary) const
+    {
+        auto itr = _table.rows.find(primary);
+        account_find(_table, itr);
+        return const_iterator(&_table, itr);
+    }
+
+    const_iterator lower_bound(uint64_t primary) const
+    {
+        auto itr = _table.rows.lower_bound(primary);
+        account_find(_table, itr);
+        return const_iterator(&_table, itr);
+    }
+
+    const T &get(uint64_t primary, const char *error_msg = "unable to find key") const
+    {
+        auto itr = find(primary);
+        eosio_assert(itr != end(), error_msg);
+        return *itr;
+    }
+
+    uint64_t available_primary_key() const
+    {
+        ++native::db_stats.finds;
+        return _table.rows.empty() ? 0 : _table.rows.rbegin()->first + 1;
+    }
+
+    template <typename Lambda>
+    const_iterator emplace(uint64_t payer, Lambda &&constructor)
+    {
+        eosio_assert(payer != 0, "must specify a valid account to pay for new record");
+        row_t row{T(), payer, 0};
+        constructor(row.value);
+        row.size = pack_size(row.value);
+        native::require_ram_payer(payer, row.size + billable_overhead);
+        const uint64_t pk = row.value.primary_key();
+        auto inserted = _table.rows.emplace(pk, std::move(row));
+        eosio_assert(inserted.second, "could not insert object, most likely a uniqueness constraint was violated");
+        index_row(inserted.first->second.value, true);
+
+        ++native::db_stats.stores;
+        native::db_stats.bytes_written += inserted.first->second.size;
+        account_ram(payer, inserted.first->second.size + billable_overhead);
+        return const_iterator(&_table, inserted.first);
+    }
+
+    template <typename Lambda>
+    void modify(const_iterator itr, uint64_t payer, Lambda &&updater)
+    {
+        eosio_assert(itr != end(), "cannot pass end iterator to modify");
+        modify(*itr, payer, std::forward<Lambda>(updater));
+    }
+
+    // the chain bills the whole row to the new payer and refunds the old one
+    template <typename Lambda>
+    void modify(const T &obj, uint64_t payer, Lambda &&updater)
+    {
+        auto &row = _table.rows.at(obj.primary_key());
+        // the row is updated on a copy, a rejected payer leaves it as it was
+        T value = row.value;
+        updater(value);
+        eosio_assert(row.value.primary_key() == value.primary_key(), "updater cannot change primary key when modifying an object");
+
+        const account_name new_payer = payer ? payer : row.payer;
+        const int64_t new_size = pack_size(value);
+        native::require_ram_payer(new_payer, new_payer == row.payer ? new_size - row.size : new_size + billable_overhead);
+
+        index_row(row.value, false);
+        row.value = std::move(value);
+        index_row(row.value, true);
+
+        account_ram(row.payer, -(row.size + billable_overhead));
+        row.payer = new_payer;
+        row.size = new_size;
+        account_ram(row.payer, row.size + billable_overhead);
+        ++native::db_stats.updates;
+        native::db_stats.bytes_written += row.size;
+    }
+
+    const_iterator erase(const_iterator itr)
+    {
+        eosio_assert(itr != end(), "cannot pass end iterator to erase");
+        auto next = erase_row(itr._itr);
+        account_find(_table, next);
+        return const_iterator(&_table, next);
+    }
+
+    void erase(const T &obj)
+    {
+        auto itr = _table.rows.find(obj.primary_key());
+        eosio_assert(itr != _table.rows.end(), "object passed to erase is not in multi_index");
+        erase_row(itr);
+    }
+
+    template <uint64_t IndexName>
+    class index
+    {
+        typedef typename std::tuple_element<index_position<IndexName>(), std::tuple<Indices...>>::type index_t;
+        typedef typename index_t::key_type key_type;
+        typedef index_set_t<index_t> set_type;
+
+        multi_index *_multi;
+
+        set_type &keys() const { return std::get<index_position<IndexName>()>(_multi->_table.indices); }
+
+      public:
+        class const_iterator
+        {
+            friend class index;
+
+            const multi_index *_multi;
+            typename set_type::const_iterator _itr;
+
+            // a step of the secondary index loads the primary row it points to
+            void account_step() const
+            {
+                ++native::db_stats.finds;
+                if (_itr != std::get<index_position<IndexName>()>(_multi->_table.indices).cend())
+                {
+                    account_find(_multi->_table, _multi->_table.rows.find(_itr->second));
+                }
+            }
+
+          public:
+            const_iterator(const multi_index *multi, typename set_type::const_iterator itr) : _multi(multi), _itr(itr) {}
+
+            const T &operator*() const { return _multi->_table.rows.at(_itr->second).value; }
+            const T *operator->() const { return &**this; }
+
+            const_iterator &operator++()
+            {
+                ++_itr;
+                account_step();
+                return *this;
+            }
+
+            friend bool operator==(const const_iterator &a, const const_iterator &b) { return a._itr == b._itr; }
+            friend bool operator!=(const const_iterator &a, const const_iterator &b) { return a._itr != b._itr; }
+        };
+
+        explicit index(multi_index *multi) : _multi(multi) {}
+
+        const_iterator begin() const
+        {
+            const_iterator itr(_multi, keys().cbegin());
+            itr.account_step();
+            return itr;
+        }
+
+        const_iterator end() const { return const_iterator(_multi, keys().cend()); }
+
+        const_iterator lower_bound(const key_type &key) const
+        {
+            const_iterator itr(_multi, keys().lower_bound(std::make_pair(key, uint64_t(0))));
+            itr.account_step();
+            return itr;
+        }
+
+        const_iterator find(const key_type &key) const
+        {
+            auto itr = lower_bound(key);
+            return itr != end() && itr._itr->first == key ? itr : end();
+        }
+
+        const_iterator erase(const_iterator itr)
+        {
+            eosio_assert(itr != end(), "cannot pass end iterator to erase");
+            auto next = itr;
+            ++next;
+            _multi->erase_row(_multi->_table.rows.find(itr._itr->second));
+            return next;
+        }
+    };
+
+    template <uint64_t IndexName>
+    index<IndexName> get_index()
+    {
+        return index<IndexName>(this);
+    }
+};
+
+} // namespace eosio
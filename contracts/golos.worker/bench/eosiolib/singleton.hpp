@@ -0,0 +1,102 @@
+#pragma once
+
+#include "eosio.hpp"
+
+namespace eosio
+{
+
+// the singleton is a table with a single row, it's accounted like one in native::db_stats
+template <uint64_t SingletonName, typename T>
+class singleton
+{
+    struct row_t
+    {
+        T value;
+        bool exists = false;
+        account_name payer = 0;
+        int64_t size = 0;
+    };
+
+    static std::map<std::pair<uint64_t, uint64_t>, row_t> &rows()
+    {
+        static std::map<std::pair<uint64_t, uint64_t>, row_t> instances;
+        return instances;
+    }
+
+    row_t &_row;
+
+    void account_find() const
+    {
+        ++native::db_stats.finds;
+        if (_row.exists)
+        {
+            ++native::db_stats.reads;
+            native::db_stats.bytes_read += _row.size;
+        }
+    }
+
+    void account_ram(int64_t delta) const
+    {
+        native::db_stats.ram_delta[_row.payer] += delta;
+    }
+
+  public:
+    singleton(account_name code, scope_name scope) : _row(rows()[std::make_pair(code, scope)]) {}
+
+    static void clear_all() { rows().clear(); }
+
+    bool exists() const
+    {
+        ++native::db_stats.finds;
+        return _row.exists;
+    }
+
+    T get() const
+    {
+        account_find();
+        eosio_assert(_row.exists, "singleton does not exist");
+        return _row.value;
+    }
+
+    T get_or_default(const T &def = T()) const
+    {
+        account_find();
+        return _row.exists ? _row.value : def;
+    }
+
+    void set(const T &value, account_name payer)
+    {
+        account_find();
+        const int64_t size = pack_size(value);
+        native::require_ram_payer(payer, _row.exists && payer == _row.payer ? size - _row.size : size + native::row_overhead);
+        if (_row.exists)
+        {
+            ++native::db_stats.updates;
+            account_ram(-(_row.size + native::row_overhead));
+        }
+        else
+        {
+            ++native::db_stats.stores;
+        }
+
+        _row.value = value;
+        _row.exists = true;
+        _row.payer = payer;
+        _row.size = size;
+        native::db_stats.bytes_written += _row.size;
+        account_ram(_row.size + native::row_overhead);
+    }
+
+    void remove()
+    {
+        account_find();
+        if (_row.exists)
+        {
+            ++native::db_stats.removes;
+            account_ram(-(_row.size + native::row_overhead));
+        }
+        _row.exists = false;
+    }
+};
+
+} // namespace eosio
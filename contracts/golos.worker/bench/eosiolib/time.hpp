@@ -0,0 +1,53 @@
+#pragma once
+
+#include "eosio.hpp"
+
+namespace eosio
+{
+
+class microseconds
+{
+  public:
+    explicit microseconds(int64_t c = 0) : _count(c) {}
+
+    int64_t count() const { return _count; }
+
+  private:
+    int64_t _count;
+};
+
+class time_point
+{
+  public:
+    explicit time_point(microseconds e = microseconds()) : elapsed(e) {}
+
+    uint32_t sec_since_epoch() const { return uint32_t(elapsed.count() / 1000000); }
+
+    microseconds elapsed;
+};
+
+/**
+ * @brief block_timestamp counts half-second slots since 2000-01-01, like the one from eosiolib
+ */
+class block_timestamp
+{
+  public:
+    explicit block_timestamp(uint32_t s = 0) : slot(s) {}
+
+    time_point to_time_point() const
+    {
+        return time_point(microseconds((int64_t(slot) * block_interval_ms + block_timestamp_epoch) * 1000));
+    }
+
+    friend bool operator==(const block_timestamp &a, const block_timestamp &b) { return a.slot == b.slot; }
+    friend bool operator!=(const block_timestamp &a, const block_timestamp &b) { return a.slot != b.slot; }
+    friend bool operator<(const block_timestamp &a, const block_timestamp &b) { return a.slot < b.slot; }
+
+    uint32_t slot;
+    static constexpr int32_t block_interval_ms = 500;
+    static constexpr int64_t block_timestamp_epoch = 946684800000ll;
+
+    EOSLIB_SERIALIZE(block_timestamp, (slot))
+};
+
+} // namespace eosio
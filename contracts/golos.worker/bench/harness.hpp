@@ -0,0 +1,159 @@
+// Helpers to drive the contract built natively against the in-memory eosiolib from
+// bench/eosiolib: actions go through apply() with packed arguments, like on chain,
+// and every run is accounted in native::db_stats.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <set>
+#include <string>
+
+#include "../main.cpp"
+
+namespace
+{
+
+using namespace eosio;
+using golos::worker;
+using std::vector;
+
+const account_name code = N(golos.worker);
+const symbol_name token_symbol = S(3, GOLOS);
+
+struct call_t
+{
+    action_name name;
+    account_name code;
+    std::set<account_name> authorizations;
+    vector<char> data;
+};
+
+account_name make_account(const char *prefix, size_t index)
+{
+    std::string str(prefix);
+    do
+    {
+        str += char('a' + index % 26);
+        index /= 26;
+    } while (index);
+    return string_to_name(str.c_str());
+}
+
+vector<account_name> make_accounts(const char *prefix, size_t count)
+{
+    vector<account_name> accounts;
+    for (size_t i = 0; i < count; ++i)
+    {
+        accounts.push_back(make_account(prefix, i));
+    }
+    return accounts;
+}
+
+template <typename... Args>
+call_t app_call(action_name name, account_name actor, account_name app, const Args &... args)
+{
+    return call_t{name, code, {actor}, pack(std::make_tuple(app, args...))};
+}
+
+call_t transfer_call(account_name from, account_name to, const asset &quantity, const std::string &memo)
+{
+    currency::transfer t{from, to, quantity, memo};
+    return call_t{N(transfer), TOKEN_ACCOUNT, {from}, pack(std::make_tuple(t))};
+}
+
+call_t transfer_call(account_name from, account_name to, int64_t amount, const std::string &memo)
+{
+    return transfer_call(from, to, asset(amount, token_symbol), memo);
+}
+
+call_t transfer_call(account_name from, account_name app, int64_t amount)
+{
+    return transfer_call(from, code, amount, name{app}.to_string());
+}
+
+// the vesting contract isn't built natively, the stakes of the members are written to its table directly,
+// the rows are written as the vesting contract and paid by it
+void give_stake(const vector<account_name> &accounts, int64_t amount)
+{
+    native::receiver = VESTING_ACCOUNT;
+    for (const account_name account : accounts)
+    {
+        worker::vesting_balances_t balances(VESTING_ACCOUNT, account);
+        auto update = [&](golos::vesting_balance_t &row) {
+            row.balance = asset(amount, token_symbol);
+        };
+        auto balance_ptr = balances.find(symbol_type(token_symbol).name());
+        if (balance_ptr == balances.end())
+        {
+            balances.emplace(VESTING_ACCOUNT, update);
+        }
+        else
+        {
+            balances.modify(balance_ptr, VESTING_ACCOUNT, update);
+        }
+    }
+}
+
+void run(const call_t &call)
+{
+    native::action_data = call.data.data();
+    native::action_data_size = call.data.size();
+    native::authorizations = call.authorizations;
+    native::receiver = code;
+    native::sent_actions.clear();
+    native::output.clear();
+    apply(code, call.code, call.name);
+}
+
+void run(const vector<call_t> &calls)
+{
+    for (const auto &call : calls)
+    {
+        run(call);
+    }
+}
+
+// runs a call that must be rejected. The rows the contract keeps until the end of the action aren't written,
+// the rows it writes directly aren't rolled back, so such a call must fail before it writes them
+bool fails(const call_t &call)
+{
+    try
+    {
+        run(call);
+    }
+    catch (const native::assert_error &)
+    {
+        return true;
+    }
+    return false;
+}
+
+// runs the call and returns the database operations it has made
+native::db_stats_t account(const call_t &call)
+{
+    native::db_stats = native::db_stats_t();
+    run(call);
+    return native::db_stats;
+}
+
+golos::tspec_data_t make_tspec(size_t index, size_t text_size = 0)
+{
+    std::string text = "Technical specification #" + std::to_string(index);
+    text.resize(std::max(text.size(), text_size), '.');
+
+    return golos::tspec_data_t{
+        .text = text,
+        .specification_cost = asset(100000, token_symbol),
+        .specification_eta = block_timestamp(3600 * 24 * 7),
+        .development_cost = asset(200000, token_symbol),
+        .development_eta = block_timestamp(3600 * 24 * 7),
+        .payments_count = 1};
+}
+
+golos::comment_data_t make_comment(const char *text)
+{
+    return golos::comment_data_t{text};
+}
+
+} // namespace
@@ -0,0 +1,153 @@
+// Decodes the raw rows of the golos.worker tables straight into the structs of rows.hpp, without
+// going through the JSON made with the ABI. get_table_rows with json=false returns every row as the
+// hex string of the bytes the contract has written:
+//
+//     {"rows":["0000000000000000...","0100000000000000..."],"more":false}
+//
+// row_reader_t finds the strings of the "rows" array without parsing the rest of the response and
+// unpacks them with the same serialization as the contract, so the layout can't drift from the
+// contract's. Malformed rows fail an eosio_assert.
+// A bench-only tool: rows.hpp needs eosiolib, which only builds natively as the stand-in from
+// bench/eosiolib, so the decoder is built with the benchmarks (see bench/rows.cpp), not shipped as an indexer.
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../rows.hpp"
+
+namespace golos
+{
+namespace indexer
+{
+
+inline int hex_digit(char c)
+{
+    if ('0' <= c && c <= '9')
+    {
+        return c - '0';
+    }
+    if ('a' <= c && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if ('A' <= c && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// hex text to bytes, the buffer is reused from a row to another
+inline void decode_hex(const char *hex, size_t size, std::vector<char> &bytes)
+{
+    eosio_assert(size % 2 == 0, "odd number of hex digits");
+    bytes.resize(size / 2);
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        const int high = hex_digit(hex[2 * i]);
+        const int low = hex_digit(hex[2 * i + 1]);
+        eosio_assert(high >= 0 && low >= 0, "invalid hex digit");
+        bytes[i] = char(high << 4 | low);
+    }
+}
+
+// the row must take all the bytes, extra bytes mean the table has another layout
+template <typename T>
+void decode_row(const char *data, size_t size, T &row)
+{
+    datastream<const char *> ds(data, size);
+    ds >> row;
+    eosio_assert(ds.remaining() == 0, "row is longer than its type");
+}
+
+/**
+ * @brief row_reader_t decodes the rows of a get_table_rows response one at a time.
+ * The response must outlive the reader, next() reuses the row object and the byte buffer
+ */
+template <typename T>
+class row_reader_t
+{
+    const char *_pos;
+    const char *_end;
+    std::vector<char> _bytes;
+
+    void skip_spaces()
+    {
+        while (_pos < _end && (*_pos == ' ' || *_pos == '\n' || *_pos == '\r' || *_pos == '\t'))
+        {
+            ++_pos;
+        }
+    }
+
+  public:
+    row_reader_t(const char *response, size_t size) : _pos(response), _end(response + size)
+    {
+        static const char key[] = "\"rows\"";
+        const char *rows = std::search(_pos, _end, key, key + sizeof(key) - 1);
+        eosio_assert(rows != _end, "no rows in the response");
+        _pos = rows + sizeof(key) - 1;
+
+        skip_spaces();
+        eosio_assert(_pos < _end && *_pos == ':', "invalid response");
+        ++_pos;
+        skip_spaces();
+        eosio_assert(_pos < _end && *_pos == '[', "rows aren't an array, json=false is expected");
+        ++_pos;
+    }
+
+    explicit row_reader_t(const std::string &response) : row_reader_t(response.data(), response.size()) {}
+
+    /**
+     * @brief next decodes the next row
+     * @return false after the last row
+     */
+    bool next(T &row)
+    {
+        skip_spaces();
+        if (_pos < _end && *_pos == ',')
+        {
+            ++_pos;
+            skip_spaces();
+        }
+        eosio_assert(_pos < _end, "unterminated rows array");
+        if (*_pos == ']')
+        {
+            return false;
+        }
+
+        eosio_assert(*_pos == '"', "rows aren't hex strings, json=false is expected");
+        const char *begin = ++_pos;
+        _pos = static_cast<const char *>(memchr(begin, '"', _end - begin));
+        eosio_assert(_pos != nullptr, "unterminated row");
+
+        decode_hex(begin, _pos - begin, _bytes);
+        ++_pos;
+
+        decode_row(_bytes.data(), _bytes.size(), row);
+        return true;
+    }
+};
+
+/**
+ * @brief for_each_row calls f with every row of a get_table_rows response
+ * @return number of the rows
+ */
+template <typename T, typename F>
+size_t for_each_row(const std::string &response, F &&f)
+{
+    row_reader_t<T> reader(response);
+    T row;
+    size_t count = 0;
+    while (reader.next(row))
+    {
+        f(static_cast<const T &>(row));
+        ++count;
+    }
+    return count;
+}
+
+} // namespace indexer
+} // namespace golos
@@ -0,0 +1,130 @@
+// Decodes the proposals, proposal bodies, funds and states rows with bench/row_decoder.hpp. The rows
+// are written by the contract built natively, packed like the chain keeps them and wrapped in a
+// get_table_rows response with json=false. Checks that every decoded row packs back to the same bytes and prints
+// the decoding throughput.
+
+#include "harness.hpp"
+#include "row_decoder.hpp"
+
+namespace
+{
+
+const size_t proposals_count = 1000;
+const size_t votes_per_proposal = 21;
+const size_t funds_count = 100;
+const size_t decode_rounds = 20;
+
+std::string to_hex(const vector<char> &bytes)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (const char c : bytes)
+    {
+        hex += digits[uint8_t(c) >> 4];
+        hex += digits[uint8_t(c) & 0xf];
+    }
+    return hex;
+}
+
+template <typename Table>
+auto read_rows(const Table &table)
+{
+    vector<std::decay_t<decltype(*table.begin())>> rows;
+    for (auto i = table.begin(); i != table.end(); ++i)
+    {
+        rows.push_back(*i);
+    }
+    return rows;
+}
+
+// the response of get_table_rows with json=false for the rows
+template <typename T>
+std::string make_response(const vector<T> &rows, vector<vector<char>> &packed)
+{
+    std::string response = "{\"rows\":[";
+    const char *separator = "";
+    for (const auto &row : rows)
+    {
+        packed.push_back(pack(row));
+        response += separator;
+        response += '"' + to_hex(packed.back()) + '"';
+        separator = ",";
+    }
+    return response + "],\"more\":false}";
+}
+
+template <typename T>
+void measure(const char *label, const vector<T> &rows)
+{
+    vector<vector<char>> packed;
+    const std::string response = make_response(rows, packed);
+
+    size_t index = 0;
+    golos::indexer::for_each_row<T>(response, [&](const T &row) {
+        eosio_assert(index < packed.size() && pack(row) == packed[index], "decoded row differs from the written one");
+        ++index;
+    });
+    eosio_assert(index == packed.size(), "rows are missing");
+
+    size_t decoded = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < decode_rounds; ++round)
+    {
+        decoded += golos::indexer::for_each_row<T>(response, [](const T &) {});
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    printf("%-10s %8zu %12zu %12.1f %12.1f\n", label, packed.size(), response.size(), ns / decoded,
+           response.size() * decode_rounds / ns * 1e3);
+}
+
+} // namespace
+
+int main()
+{
+    native::now = 1500000000;
+
+    const account_name app = make_account("golos", 0);
+    const auto members = make_accounts("member", votes_per_proposal);
+    const auto sponsors = make_accounts("sponsor", funds_count);
+
+    try
+    {
+        give_stake({app}, 1000000);
+        give_stake(members, 1000000);
+        give_stake(sponsors, 1000000);
+
+        run(app_call(N(createpool), app, app, token_symbol, uint8_t(golos::state_t::COMMENTS_STORED)));
+        for (const account_name sponsor : sponsors)
+        {
+            run(transfer_call(sponsor, app, 1000000));
+        }
+
+        for (golos::proposal_id_t id = 0; id < proposals_count; ++id)
+        {
+            const account_name author = members[id % members.size()];
+            run(app_call(N(addpropos), author, app, id, author, std::string("Proposal"), std::string("Description")));
+            run(app_call(N(setfund), sponsors[id % sponsors.size()], app, id, sponsors[id % sponsors.size()],
+                         asset(1000, token_symbol)));
+            for (size_t i = 0; i < votes_per_proposal; ++i)
+            {
+                run(app_call(N(votepropos), members[i], app, id, members[i], uint8_t(i % 2)));
+            }
+        }
+
+        printf("%-10s %8s %12s %12s %12s\n", "table", "rows", "bytes", "ns/row", "MB/s");
+        measure("proposals", read_rows(worker::proposals_t(code, app)));
+        measure("bodies", read_rows(worker::proposal_bodies_t(code, app)));
+        measure("funds", read_rows(worker::funds_t(code, app)));
+        measure("states", vector<golos::state_t>{singleton<N(states), golos::state_t>(code, app).get()});
+    }
+    catch (const native::assert_error &e)
+    {
+        fprintf(stderr, "assertion failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,241 @@
+// Checks that the actions on a single proposal make the same database operations
+// whatever the size of the proposal: a small proposal and a large one with a long
+// description, many comments, votes and tspec applications get the same calls, and
+// every difference in the accounted finds, reads, writes, bytes or RAM is a failure.
+// Actions that load the proposal body (choosing a tspec, the work status, closing
+// the proposal) are run but not compared, they read the description by design.
+// The suite runs in both comment modes, in the hashed one a long comment must cost
+// the same as a short one. The stand-in send() fails the inline actions above the
+// chain's max_inline_action_size, like the 16 KiB comment would on chain.
+
+#include "harness.hpp"
+
+namespace
+{
+
+const size_t title_size = 256;
+const size_t description_size = 16 * 1024;
+const size_t large_comments_count = 1000;
+const size_t large_votes_count = 100;
+const size_t large_tspecs_count = 100;
+const size_t tspec_text_size = 1024;
+
+const golos::proposal_id_t small = 0;
+const golos::proposal_id_t large = 1;
+
+// a lookup of a secondary index loads the next row when it misses, the sentinel proposal
+// puts the same row next to the small and the large one
+const golos::proposal_id_t sentinel = 2;
+
+// ids and authors used by the compared calls, out of the range of the large proposal
+const golos::comment_id_t checked_comment = large_comments_count;
+const golos::tspec_id_t checked_tspec = large_tspecs_count;
+
+std::string make_text(char c, size_t size)
+{
+    return std::string(size, c);
+}
+
+int64_t total_ram(const native::db_stats_t &stats)
+{
+    int64_t total = 0;
+    for (const auto &delta : stats.ram_delta)
+    {
+        total += delta.second;
+    }
+    return total;
+}
+
+// the payers are not compared: a modify bills the row to the new payer and refunds the
+// previous one, who differs from a proposal to another
+std::string diff(const native::db_stats_t &a, const native::db_stats_t &b)
+{
+    std::string result;
+    auto compare = [&](const char *field, int64_t x, int64_t y) {
+        if (x != y)
+        {
+            result += std::string(" ") + field + " " + std::to_string(x) + " -> " + std::to_string(y);
+        }
+    };
+
+    compare("finds", a.finds, b.finds);
+    compare("reads", a.reads, b.reads);
+    compare("updates", a.updates, b.updates);
+    compare("stores", a.stores, b.stores);
+    compare("removes", a.removes, b.removes);
+    compare("bytes_read", a.bytes_read, b.bytes_read);
+    compare("bytes_written", a.bytes_written, b.bytes_written);
+    compare("ram", total_ram(a), total_ram(b));
+    return result;
+}
+
+class suite_t
+{
+    const account_name _app;
+    const uint8_t _comment_mode;
+    const vector<account_name> _delegates;
+    const vector<account_name> _members;
+    size_t _failures = 0;
+
+    account_name member(size_t i) const { return _members[i % _members.size()]; }
+
+    template <typename... Args>
+    call_t call(action_name action, account_name actor, golos::proposal_id_t proposal_id, const Args &... args) const
+    {
+        return app_call(action, actor, _app, proposal_id, args...);
+    }
+
+    void compare(const char *label, const native::db_stats_t &small_stats, const native::db_stats_t &large_stats)
+    {
+        const auto difference = diff(small_stats, large_stats);
+        printf("%-4s %-14s%s\n", difference.empty() ? "ok" : "FAIL", label, difference.c_str());
+        _failures += !difference.empty();
+    }
+
+    // runs the call on the small and the large proposal and compares them
+    template <typename... Args>
+    void check(const char *label, action_name action, account_name actor, const Args &... args)
+    {
+        const auto small_stats = account(call(action, actor, small, args...));
+        const auto large_stats = account(call(action, actor, large, args...));
+        compare(label, small_stats, large_stats);
+    }
+
+    template <typename... Args>
+    void run_both(action_name action, account_name actor, const Args &... args) const
+    {
+        run(call(action, actor, small, args...));
+        run(call(action, actor, large, args...));
+    }
+
+  public:
+    suite_t(account_name app, uint8_t comment_mode)
+        : _app(app),
+          _comment_mode(comment_mode),
+          _delegates(make_accounts("delegate", witness_count)),
+          _members(make_accounts("member", large_votes_count))
+    {
+    }
+
+    void setup() const
+    {
+        give_stake({_app}, 1000000);
+        give_stake(_delegates, 1000000);
+        give_stake(_members, 1000000);
+
+        run(app_call(N(createpool), _app, _app, token_symbol, _comment_mode));
+        run(app_call(N(setdelegates), _app, _app, _delegates));
+        run(transfer_call(_app, _app, 10000000));
+
+        run(app_call(N(addpropos), member(0), _app, small, member(0), std::string("Small"), std::string("s")));
+        run(app_call(N(addpropos), member(0), _app, large, member(0), make_text('t', title_size),
+                     make_text('d', description_size)));
+
+        run(app_call(N(addpropos), member(0), _app, sentinel, member(0), std::string("Sentinel"), std::string("s")));
+        run(app_call(N(addcomment), member(0), _app, sentinel, golos::comment_id_t(0), member(0), make_comment("Let's do it!")));
+        run(app_call(N(votepropos), member(0), _app, sentinel, member(0), uint8_t(1)));
+        run(app_call(N(addtspec), member(0), _app, sentinel, golos::tspec_id_t(0), member(0), make_tspec(0, tspec_text_size)));
+
+        for (golos::comment_id_t comment_id = 0; comment_id < large_comments_count; ++comment_id)
+        {
+            const account_name author = member(comment_id);
+            run(app_call(N(addcomment), author, _app, large, comment_id, author, make_comment("Let's do it!")));
+        }
+        for (size_t i = 0; i < large_votes_count; ++i)
+        {
+            run(app_call(N(votepropos), member(i), _app, large, member(i), uint8_t(i % 2)));
+        }
+        for (golos::tspec_id_t tspec_id = 0; tspec_id < large_tspecs_count; ++tspec_id)
+        {
+            const account_name author = member(tspec_id);
+            run(app_call(N(addtspec), author, _app, large, tspec_id, author, make_tspec(tspec_id, tspec_text_size)));
+        }
+    }
+
+    size_t run_all()
+    {
+        const account_name commenter = make_account("commenter", 0);
+        const account_name voter = make_account("voter", 0);
+        const account_name tspec_author = make_account("author", 0);
+        const account_name worker_account = make_account("worker", 0);
+        give_stake({commenter, voter, tspec_author, worker_account}, 1000000);
+
+        // the first vote or application of a member in the epoch takes the snapshot of its stake,
+        // it is taken on the sentinel proposal to compare the same calls
+        run(app_call(N(votepropos), voter, _app, sentinel, voter, uint8_t(1)));
+        run(app_call(N(addtspec), tspec_author, _app, sentinel, golos::tspec_id_t(1), tspec_author, make_tspec(1, tspec_text_size)));
+
+        check("addcomment", N(addcomment), commenter, checked_comment, commenter, make_comment("Let's do it!"));
+        check("editcomment", N(editcomment), commenter, checked_comment, make_comment("Noooo!"));
+
+        if (_comment_mode == golos::state_t::COMMENTS_HASHED)
+        {
+            const golos::comment_id_t long_comment = checked_comment + 1;
+            const auto short_stats = account(call(N(addcomment), commenter, small, long_comment, commenter, make_comment("Short")));
+            const auto long_stats = account(call(N(addcomment), commenter, large, long_comment, commenter,
+                                                 golos::comment_data_t{make_text('c', description_size)}));
+            compare("long comment", short_stats, long_stats);
+        }
+        check("votepropos", N(votepropos), voter, voter, uint8_t(1));
+        check("addtspec", N(addtspec), tspec_author, checked_tspec, tspec_author, make_tspec(checked_tspec, tspec_text_size));
+        check("edittspec", N(edittspec), tspec_author, checked_tspec, make_tspec(checked_tspec + 1, tspec_text_size));
+
+        // the vote of the majority chooses the tspec and copies its text to the body
+        for (size_t i = 0; i + 1 < witness_count_51; ++i)
+        {
+            check("votetspec", N(votetspec), _delegates[i], checked_tspec, _delegates[i], uint8_t(1),
+                  golos::comment_id_t(i), make_comment("I agree"));
+        }
+        run_both(N(votetspec), _delegates[witness_count_51 - 1], checked_tspec, _delegates[witness_count_51 - 1],
+                 uint8_t(1), golos::comment_id_t(witness_count_51 - 1), make_comment("I agree"));
+
+        auto terms = make_tspec(checked_tspec);
+        terms.text.clear();
+        check("publishtspec", N(publishtspec), tspec_author, terms);
+        check("startwork", N(startwork), tspec_author, worker_account);
+
+        run_both(N(poststatus), worker_account, golos::comment_id_t(0), make_comment("Work is done"), true);
+        run_both(N(acceptwork), tspec_author, golos::comment_id_t(1), make_comment("All work done well"));
+
+        for (size_t i = 0; i < witness_count_51; ++i)
+        {
+            check("reviewwork", N(reviewwork), _delegates[i], _delegates[i], uint8_t(1), golos::comment_id_t(2 + i),
+                  make_comment("Lorem ipsum dolor sit am"));
+        }
+        run_both(N(withdraw), worker_account);
+        check("delcomment", N(delcomment), commenter, checked_comment);
+
+        return _failures;
+    }
+};
+
+} // namespace
+
+int main()
+{
+    native::now = 1500000000;
+
+    try
+    {
+        size_t failures = 0;
+        for (const uint8_t comment_mode : {golos::state_t::COMMENTS_STORED, golos::state_t::COMMENTS_HASHED})
+        {
+            printf("comment mode %d\n", int(comment_mode));
+            suite_t suite(make_account("golos", comment_mode), comment_mode);
+            suite.setup();
+            failures += suite.run_all();
+        }
+        if (failures)
+        {
+            fprintf(stderr, "the database operations of some actions depend on the size of the proposal\n");
+            return 1;
+        }
+    }
+    catch (const native::assert_error &e)
+    {
+        fprintf(stderr, "assertion failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,647 @@
+// Times every action of the contract built natively against the in-memory eosiolib
+// from bench/eosiolib. Actions go through apply() with packed arguments, like on chain,
+// at the sizes we expect: 21 delegates, 100 proposals, 1k comments, 100 tspec apps per proposal.
+// Prints the database operations per call next to the time, `bench/worker --json` prints
+// them as one JSON object per action.
+
+#include "harness.hpp"
+
+namespace
+{
+
+const size_t delegates_count = witness_count;
+const size_t members_count = 100;
+const size_t proposals_count = 100;
+const size_t comments_per_proposal = 10;
+const size_t tspecs_per_proposal = 100;
+
+// one JSON object per action instead of the table, totals over all the calls
+bool json_report = false;
+
+void print_header()
+{
+    if (!json_report)
+    {
+        printf("%-14s %8s %12s %7s %7s %7s %7s %7s %9s %9s %9s\n", "action", "calls", "ns/call",
+               "finds", "reads", "updates", "stores", "removes", "bytes_r", "bytes_w", "ram");
+    }
+}
+
+void print_report(const char *label, size_t calls, double ns, const native::db_stats_t &db)
+{
+    int64_t ram = 0;
+    for (const auto &delta : db.ram_delta)
+    {
+        ram += delta.second;
+    }
+
+    if (!json_report)
+    {
+        const double n = calls;
+        printf("%-14s %8zu %12.1f %7.1f %7.1f %7.1f %7.1f %7.1f %9.1f %9.1f %9.1f\n", label, calls, ns,
+               db.finds / n, db.reads / n, db.updates / n, db.stores / n, db.removes / n,
+               db.bytes_read / n, db.bytes_written / n, ram / n);
+        return;
+    }
+
+    printf("{\"action\":\"%s\",\"calls\":%zu,\"ns_per_call\":%.1f,\"finds\":%llu,\"reads\":%llu,\"updates\":%llu,"
+           "\"stores\":%llu,\"removes\":%llu,\"bytes_read\":%llu,\"bytes_written\":%llu,\"ram_delta\":{",
+           label, calls, ns, (unsigned long long)db.finds, (unsigned long long)db.reads, (unsigned long long)db.updates,
+           (unsigned long long)db.stores, (unsigned long long)db.removes, (unsigned long long)db.bytes_read,
+           (unsigned long long)db.bytes_written);
+    const char *separator = "";
+    for (const auto &delta : db.ram_delta)
+    {
+        printf("%s\"%s\":%lld", separator, name{delta.first}.to_string().c_str(), (long long)delta.second);
+        separator = ",";
+    }
+    printf("}}\n");
+}
+
+void measure(const char *label, const vector<call_t> &calls)
+{
+    native::db_stats = native::db_stats_t();
+
+    auto start = std::chrono::steady_clock::now();
+    run(calls);
+    auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count() / calls.size();
+    print_report(label, calls.size(), ns, native::db_stats);
+}
+
+class scenario_t
+{
+    const account_name _app;
+    const account_name _sponsor;
+    const vector<account_name> _delegates;
+    const vector<account_name> _members;
+
+    account_name member(size_t i) const { return _members[i % _members.size()]; }
+
+    account_name tspec_author(golos::proposal_id_t proposal_id, golos::tspec_id_t tspec_id) const
+    {
+        return member(proposal_id + tspec_id);
+    }
+
+    vector<call_t> add_proposals(golos::proposal_id_t first) const
+    {
+        vector<call_t> calls;
+        for (golos::proposal_id_t id = first; id < first + proposals_count; ++id)
+        {
+            calls.push_back(app_call(N(addpropos), member(id), _app, id, member(id),
+                                     std::string("Proposal #") + std::to_string(id),
+                                     std::string("Let's create worker's pool")));
+        }
+        return calls;
+    }
+
+    vector<call_t> add_comments(golos::proposal_id_t first, action_name action) const
+    {
+        vector<call_t> calls;
+        for (golos::proposal_id_t id = first; id < first + proposals_count; ++id)
+        {
+            for (golos::comment_id_t comment_id = 0; comment_id < comments_per_proposal; ++comment_id)
+            {
+                const account_name author = member(id + comment_id);
+                if (action == N(addcomment))
+                {
+                    calls.push_back(app_call(action, author, _app, id, comment_id, author, make_comment("Let's do it!")));
+                }
+                else if (action == N(editcomment))
+                {
+                    calls.push_back(app_call(action, author, _app, id, comment_id, make_comment("Noooo!")));
+                }
+                else
+                {
+                    calls.push_back(app_call(action, author, _app, id, comment_id));
+                }
+            }
+        }
+        return calls;
+    }
+
+    vector<call_t> add_tspecs(golos::proposal_id_t first, size_t count, action_name action) const
+    {
+        vector<call_t> calls;
+        for (golos::proposal_id_t id = first; id < first + proposals_count; ++id)
+        {
+            for (golos::tspec_id_t tspec_id = 0; tspec_id < count; ++tspec_id)
+            {
+                const account_name author = tspec_author(id, tspec_id);
+                if (action == N(addtspec))
+                {
+                    calls.push_back(app_call(action, author, _app, id, tspec_id, author, make_tspec(tspec_id)));
+                }
+                else
+                {
+                    calls.push_back(app_call(action, author, _app, id, tspec_id, make_tspec(tspec_id)));
+                }
+            }
+        }
+        return calls;
+    }
+
+    vector<call_t> del_tspecs(golos::proposal_id_t first) const
+    {
+        vector<call_t> calls;
+        for (golos::proposal_id_t id = first; id < first + proposals_count; ++id)
+        {
+            for (golos::tspec_id_t tspec_id = tspecs_per_proposal / 2; tspec_id < tspecs_per_proposal; ++tspec_id)
+            {
+                calls.push_back(app_call(N(deltspec), tspec_author(id, tspec_id), _app, id, tspec_id));
+            }
+        }
+        return calls;
+    }
+
+    // a majority of the delegates upvotes the tspec application 0, the other applications are left to prunepropos
+    vector<call_t> choose_tspecs(golos::proposal_id_t first) const
+    {
+        vector<call_t> calls;
+        for (golos::proposal_id_t id = first; id < first + proposals_count; ++id)
+        {
+            for (size_t i = 0; i < witness_count_51; ++i)
+            {
+                calls.push_back(app_call(N(votetspec), _delegates[i], _app, id, golos::tspec_id_t(0), _delegates[i],
+                                         uint8_t(1), golos::comment_id_t(i), make_comment("I agree")));
+            }
+        }
+        return calls;
+    }
+
+    vector<call_t> start_work(golos::proposal_id_t first) const
+    {
+        vector<call_t> calls;
+        for (golos::proposal_id_t id = first; id < first + proposals_count; ++id)
+        {
+            calls.push_back(app_call(N(startwork), tspec_author(id, 0), _app, id, member(id + 1)));
+        }
+        return calls;
+    }
+
+  public:
+    scenario_t(account_name app)
+        : _app(app),
+          _sponsor(make_account("sponsor", 0)),
+          _delegates(make_accounts("delegate", delegates_count)),
+          _members(make_accounts("member", members_count))
+    {
+    }
+
+    void setup() const
+    {
+        give_stake({_app, _sponsor}, 1000000);
+        give_stake(_delegates, 1000000);
+        give_stake(_members, 1000000);
+
+        run(app_call(N(createpool), _app, _app, token_symbol, uint8_t(golos::state_t::COMMENTS_STORED)));
+        run(app_call(N(setdelegates), _app, _app, _delegates));
+    }
+
+    void run_all() const
+    {
+        const golos::proposal_id_t work = 0;
+        const golos::proposal_id_t cancelled = proposals_count;
+        const golos::proposal_id_t deleted = 2 * proposals_count;
+        const golos::proposal_id_t done = 3 * proposals_count;
+        const golos::proposal_id_t batched = 4 * proposals_count;
+        const golos::proposal_id_t expiring = 5 * proposals_count;
+
+        vector<call_t> calls;
+
+        for (size_t i = 0; i < proposals_count; ++i)
+        {
+            calls.push_back(app_call(N(setdelegates), _app, _app, _delegates));
+        }
+        measure("setdelegates", calls);
+
+        calls.clear();
+        for (size_t i = 0; i < members_count; ++i)
+        {
+            calls.push_back(app_call(N(updstake), _app, _app, member(i)));
+        }
+        measure("updstake", calls);
+
+        calls.clear();
+        for (size_t i = 0; i < proposals_count; ++i)
+        {
+            calls.push_back(transfer_call(_app, _app, 1000000));
+            calls.push_back(transfer_call(_sponsor, _app, 1000000));
+        }
+        measure("transfer", calls);
+
+        // the transfers of another token of the token contract reach deposit, which rejects them,
+        // so the transfer is aborted and the sender keeps the tokens
+        const int64_t sponsor_amount = worker::funds_t(code, _app).get(_sponsor).quantity.amount;
+        eosio_assert(fails(transfer_call(_sponsor, code, asset(1000, S(3, OTHER)), name{_app}.to_string())),
+                     "transfer of another token is accepted");
+        eosio_assert(worker::funds_t(code, _app).get(_sponsor).quantity.amount == sponsor_amount,
+                     "transfer of another token is credited");
+
+        // one transfer to the funds of two application domains
+        const account_name pool_a = make_account("app", 0);
+        const account_name pool_b = make_account("app", 1);
+        const std::string split_memo = name{pool_a}.to_string() + ":1000," + name{pool_b}.to_string() + ":3000";
+        calls.clear();
+        for (size_t i = 0; i < proposals_count; ++i)
+        {
+            calls.push_back(transfer_call(_sponsor, code, 4000, split_memo));
+        }
+        measure("transfer split", calls);
+        eosio_assert(worker::funds_t(code, pool_b).get(_sponsor).quantity.amount == 3000 * proposals_count,
+                     "split transfer isn't credited");
+
+        // the notifications of the payments made by the contract are dropped before unpacking
+        calls.clear();
+        for (size_t i = 0; i < proposals_count; ++i)
+        {
+            calls.push_back(transfer_call(code, _sponsor, 1000, "worker reward"));
+        }
+        measure("transfer out", calls);
+
+        // the whole life cycle of a proposal
+        measure("addpropos", add_proposals(work));
+
+        calls.clear();
+        for (golos::proposal_id_t id = work; id < work + proposals_count; ++id)
+        {
+            calls.push_back(app_call(N(editpropos), member(id), _app, id, std::string("Proposal"), std::string("")));
+        }
+        measure("editpropos", calls);
+
+        calls.clear();
+        for (golos::proposal_id_t id = work; id < work + proposals_count; ++id)
+        {
+            for (size_t i = 0; i < witness_count; ++i)
+            {
+                calls.push_back(app_call(N(votepropos), member(id + i), _app, id, member(id + i), uint8_t(i % 2)));
+            }
+        }
+        measure("votepropos", calls);
+
+        measure("addcomment", add_comments(work, N(addcomment)));
+        measure("editcomment", add_comments(work, N(editcomment)));
+
+        // the stake weighs only the votes and the applications, a member without it manages their own comments
+        const account_name no_stake = make_account("nostake", 0);
+        const golos::comment_id_t no_stake_comment = comments_per_proposal;
+        run(app_call(N(addcomment), no_stake, _app, work, no_stake_comment, no_stake, make_comment("No stake")));
+        run(app_call(N(editcomment), no_stake, _app, work, no_stake_comment, make_comment("Still no stake")));
+        run(app_call(N(delcomment), no_stake, _app, work, no_stake_comment));
+        eosio_assert(fails(app_call(N(votepropos), no_stake, _app, work, no_stake, uint8_t(1))),
+                     "member without stake votes for a proposal");
+        measure("addtspec", add_tspecs(work, tspecs_per_proposal, N(addtspec)));
+        eosio_assert(fails(app_call(N(addtspec), member(0), _app, work, golos::tspec_id_t(tspecs_per_proposal), member(1),
+                                    make_tspec(0))),
+                     "application is added without the authority of its author");
+        auto no_payments = make_tspec(0);
+        no_payments.payments_count = 0;
+        eosio_assert(fails(app_call(N(addtspec), member(0), _app, work, golos::tspec_id_t(tspecs_per_proposal), member(0),
+                                    no_payments)),
+                     "application without payments is added");
+        measure("edittspec", add_tspecs(work, tspecs_per_proposal, N(edittspec)));
+        measure("deltspec", del_tspecs(work));
+        measure("votetspec", choose_tspecs(work));
+
+        // the work is paid in 3 payments that vest until the development deadline
+        const uint32_t development_s = 4 * 24 * 3600;
+        auto terms = make_tspec(0);
+        terms.payments_count = 3;
+        terms.development_eta = block_timestamp((int64_t(native::now + development_s) * 1000 - block_timestamp::block_timestamp_epoch) /
+                                                block_timestamp::block_interval_ms);
+
+        calls.clear();
+        for (golos::proposal_id_t id = work; id < work + proposals_count; ++id)
+        {
+            calls.push_back(app_call(N(publishtspec), tspec_author(id, 0), _app, id, terms));
+        }
+        measure("publishtspec", calls);
+
+        measure("startwork", start_work(work));
+
+        calls.clear();
+        for (bool finished : {false, true})
+        {
+            for (golos::proposal_id_t id = work; id < work + proposals_count; ++id)
+            {
+                calls.push_back(app_call(N(poststatus), member(id + 1), _app, id, golos::comment_id_t(finished),
+                                         make_comment("Work in progress"), finished));
+            }
+        }
+        measure("poststatus", calls);
+
+        calls.clear();
+        for (golos::proposal_id_t id = work; id < work + proposals_count; ++id)
+        {
+            calls.push_back(app_call(N(acceptwork), tspec_author(id, 0), _app, id, golos::comment_id_t(2),
+                                     make_comment("All work done well")));
+        }
+        measure("acceptwork", calls);
+
+        calls.clear();
+        for (golos::proposal_id_t id = work; id < work + proposals_count; ++id)
+        {
+            for (size_t i = 0; i < delegates_count; ++i)
+            {
+                calls.push_back(app_call(N(reviewwork), _delegates[i], _app, id, _delegates[i], uint8_t((i + 1) % 2),
+                                         golos::comment_id_t(3 + i), make_comment("Lorem ipsum dolor sit am")));
+            }
+        }
+        measure("reviewwork", calls);
+
+        // all the payments have vested, the workers of a half of the proposals withdraw them at once,
+        // the crank pays the other half
+        native::now += development_s;
+
+        calls.clear();
+        for (golos::proposal_id_t id = work; id < work + proposals_count / 2; ++id)
+        {
+            calls.push_back(app_call(N(withdraw), member(id + 1), _app, id));
+        }
+        measure("withdraw", calls);
+
+        calls.clear();
+        for (size_t i = 0; i < proposals_count / 2 / 10; ++i)
+        {
+            calls.push_back(app_call(N(processpays), member(i), _app, uint32_t(10)));
+        }
+        measure("processpays", calls);
+
+        worker::proposal_summaries_t summaries(code, _app);
+        for (golos::proposal_id_t id = work; id < work + proposals_count; ++id)
+        {
+            eosio_assert(summaries.get(id, "proposal isn't closed after the last payment").outcome ==
+                             golos::proposal_summary_t::OUTCOME_PAID,
+                         "work isn't paid");
+        }
+
+        measure("delcomment", add_comments(work, N(delcomment)));
+
+        // the comments and the votes are kept for the retention period
+        eosio_assert(fails(app_call(N(prunepropos), member(0), _app, work, uint32_t(witness_count))),
+                     "closed proposal is pruned before the retention period is over");
+
+        measure("setretention", {app_call(N(setretention), _app, _app, uint32_t(0))});
+
+        // the applications that have lost and the votes of the delegates are left after the comments are deleted
+        calls.clear();
+        for (golos::proposal_id_t id = work; id < work + proposals_count; ++id)
+        {
+            calls.push_back(app_call(N(prunepropos), member(id), _app, id, uint32_t(tspecs_per_proposal / 2 + witness_count)));
+        }
+        measure("prunepropos", calls);
+
+        // the crank erases the summaries of the closed proposals by 10 rows a call
+        calls.clear();
+        for (size_t i = 0; i < proposals_count / 10; ++i)
+        {
+            calls.push_back(app_call(N(cleanup), member(i), _app, golos::proposal_id_t(0), uint32_t(10)));
+        }
+        measure("cleanup", calls);
+
+        eosio_assert(summaries.begin() == summaries.end(), "summaries are left after the cleanup");
+
+        // proposals funded by a sponsor, the work is cancelled
+        run(add_proposals(cancelled));
+
+        calls.clear();
+        for (golos::proposal_id_t id = cancelled; id < cancelled + proposals_count; ++id)
+        {
+            calls.push_back(app_call(N(setfund), _sponsor, _app, id, _sponsor, asset(300000, token_symbol)));
+        }
+        measure("setfund", calls);
+
+        run(add_tspecs(cancelled, 1, N(addtspec)));
+        run(choose_tspecs(cancelled));
+        run(start_work(cancelled));
+
+        calls.clear();
+        for (golos::proposal_id_t id = cancelled; id < cancelled + proposals_count; ++id)
+        {
+            calls.push_back(app_call(N(cancelwork), member(id + 1), _app, id, member(id + 1)));
+        }
+        measure("cancelwork", calls);
+
+        // proposals with comments and tspec applications that are deleted
+        run(add_proposals(deleted));
+        run(add_comments(deleted, N(addcomment)));
+        run(add_tspecs(deleted, tspecs_per_proposal, N(addtspec)));
+
+        // a half of them is funded, the deposits go back to the fund
+        const auto sponsor_fund = worker::funds_t(code, _app).get(_sponsor).quantity;
+        for (golos::proposal_id_t id = deleted; id < deleted + proposals_count / 2; ++id)
+        {
+            run(app_call(N(setfund), _sponsor, _app, id, _sponsor, asset(100000, token_symbol)));
+        }
+
+        // 100 applications and 10 comments by 25 rows a call, the proposal is erased by the last call
+        const uint32_t delete_budget = 25;
+        const size_t delete_calls = (tspecs_per_proposal + comments_per_proposal + delete_budget - 1) / delete_budget;
+        for (golos::proposal_id_t id = deleted; id < deleted + proposals_count; ++id)
+        {
+            run(app_call(N(delpropos), member(id), _app, id, delete_budget));
+            eosio_assert(worker::proposals_t(code, _app).find(id) != worker::proposals_t(code, _app).end(),
+                         "proposal is erased before its applications and comments");
+        }
+
+        calls.clear();
+        for (size_t i = 1; i < delete_calls; ++i)
+        {
+            for (golos::proposal_id_t id = deleted; id < deleted + proposals_count; ++id)
+            {
+                calls.push_back(app_call(N(delpropos), member(id), _app, id, delete_budget));
+            }
+        }
+        measure("delpropos", calls);
+        for (golos::proposal_id_t id = deleted; id < deleted + proposals_count; ++id)
+        {
+            eosio_assert(worker::proposals_t(code, _app).find(id) == worker::proposals_t(code, _app).end(), "proposal isn't deleted");
+        }
+        eosio_assert(worker::funds_t(code, _app).get(_sponsor).quantity == sponsor_fund, "deposits of the deleted proposals aren't refunded");
+
+        // proposals for the done work
+        calls.clear();
+        for (golos::proposal_id_t id = done; id < done + proposals_count; ++id)
+        {
+            calls.push_back(app_call(N(addpropos2), member(id), _app, id, member(id),
+                                     std::string("Proposal #") + std::to_string(id), std::string("Work is done"),
+                                     make_tspec(0), member(id + 1)));
+        }
+        measure("addpropos2", calls);
+        eosio_assert(fails(app_call(N(addpropos2), member(0), _app, done + proposals_count, member(0), std::string("Proposal"),
+                                    std::string("Work is done"), no_payments, member(1))),
+                     "proposal without payments is added");
+
+        // the member votes and the comments of a proposal in one batch
+        run(add_proposals(batched));
+
+        calls.clear();
+        for (golos::proposal_id_t id = batched; id < batched + proposals_count; ++id)
+        {
+            vector<worker::batch_op_t> ops;
+            std::set<account_name> authors;
+            for (size_t i = 0; i < witness_count; ++i)
+            {
+                ops.push_back(worker::batch_op_t{worker::batch_op_t::OP_VOTEPROPOS, id, 0, member(id + i), uint8_t(i % 2), 0, {}});
+                authors.insert(member(id + i));
+            }
+            for (golos::comment_id_t comment_id = 0; comment_id < comments_per_proposal; ++comment_id)
+            {
+                ops.push_back(worker::batch_op_t{worker::batch_op_t::OP_ADDCOMMENT, id, 0, member(id + comment_id), 0, comment_id,
+                                                 make_comment("Let's do it!")});
+            }
+
+            call_t call = app_call(N(batch), member(id), _app, ops);
+            call.authorizations = authors;
+            calls.push_back(call);
+        }
+        measure("batch", calls);
+
+        // proposals funded by a sponsor that don't choose a tspec, they expire with
+        // the batched proposals and the proposals for the done work
+        run(add_proposals(expiring));
+        run(add_tspecs(expiring, 10, N(addtspec)));
+
+        calls.clear();
+        for (golos::proposal_id_t id = expiring; id < expiring + proposals_count; ++id)
+        {
+            calls.push_back(app_call(N(setfund), _sponsor, _app, id, _sponsor, asset(100000, token_symbol)));
+        }
+        run(calls);
+
+        const uint32_t now = native::now;
+        native::now += worker::voting_time_s + 1;
+
+        // every call with the smallest budget erases an application or closes a proposal, the calls
+        // close the batched proposals and go on with the applications of the first expiring one
+        auto expiring_rows = [&] {
+            size_t rows = 0;
+            for (auto i = worker::tspec_apps_t(code, _app).begin(); i != worker::tspec_apps_t(code, _app).end(); ++i)
+            {
+                ++rows;
+            }
+            for (auto i = worker::proposals_t(code, _app).begin(); i != worker::proposals_t(code, _app).end(); ++i)
+            {
+                ++rows;
+            }
+            return rows;
+        };
+        const size_t rows_before = expiring_rows();
+        for (size_t i = 0; i < proposals_count + 30; ++i)
+        {
+            run(app_call(N(expire), member(i), _app, uint32_t(1)));
+        }
+        eosio_assert(expiring_rows() + proposals_count + 30 == rows_before, "expire(1) hasn't made progress");
+
+        // the remaining 1270 proposals and tspecs by 20 rows a call
+        calls.clear();
+        for (size_t i = 0; i < 70; ++i)
+        {
+            calls.push_back(app_call(N(expire), member(i), _app, uint32_t(20)));
+        }
+        measure("expire", calls);
+        native::now = now;
+
+        for (golos::proposal_id_t id = expiring; id < expiring + proposals_count; ++id)
+        {
+            const auto &summary = summaries.get(id, "proposal hasn't expired");
+            eosio_assert(summary.outcome == golos::proposal_summary_t::OUTCOME_EXPIRED, "proposal hasn't expired");
+            eosio_assert(summary.refunded.amount == 100000, "deposit isn't refunded");
+        }
+
+        // the statistics kept by the actions must match the ones recounted from the rows
+        size_t rows = 0;
+        for (auto i = worker::proposals_t(code, _app).begin(); i != worker::proposals_t(code, _app).end(); ++i)
+        {
+            ++rows;
+        }
+        for (auto i = worker::funds_t(code, _app).begin(); i != worker::funds_t(code, _app).end(); ++i)
+        {
+            ++rows;
+        }
+
+        singleton<N(stats), golos::stats_t> stats(code, _app);
+        const auto kept = stats.get();
+
+        calls.clear();
+        for (size_t i = 0; i < (rows + 49) / 50; ++i)
+        {
+            calls.push_back(app_call(N(rebuildstats), _app, _app, uint32_t(50)));
+        }
+        measure("rebuildstats", calls);
+
+        const auto rebuilt = stats.get();
+        eosio_assert(kept.proposals == rebuilt.proposals && kept.funds == rebuilt.funds && kept.deposits == rebuilt.deposits,
+                     "statistics have drifted");
+        eosio_assert(kept.transferred == kept.funds + kept.deposits + kept.tspec_author_paid + kept.worker_paid,
+                     "transferred tokens aren't accounted");
+
+        // the upvote of a removed delegate doesn't keep the application from the deletion
+        const golos::proposal_id_t replaced = 6 * proposals_count;
+        run(app_call(N(addpropos), member(0), _app, replaced, member(0), std::string("Proposal"), std::string("")));
+        run(app_call(N(addtspec), member(1), _app, replaced, golos::tspec_id_t(0), member(1), make_tspec(0)));
+        run(app_call(N(votetspec), _delegates[0], _app, replaced, golos::tspec_id_t(0), _delegates[0], uint8_t(1),
+                     golos::comment_id_t(0), make_comment("")));
+        eosio_assert(fails(app_call(N(deltspec), member(1), _app, replaced, golos::tspec_id_t(0))),
+                     "upvoted application is deleted");
+
+        run(app_call(N(setdelegates), _app, _app, vector<account_name>(_delegates.begin() + 1, _delegates.end())));
+        run(app_call(N(deltspec), member(1), _app, replaced, golos::tspec_id_t(0)));
+
+        // the deciding vote fails in a pool without a fund, the votes and the comments of the failed vote aren't written
+        const account_name unfunded = make_account("app", 2);
+        run(app_call(N(setdelegates), unfunded, unfunded, _delegates));
+        run(app_call(N(addpropos), member(0), unfunded, golos::proposal_id_t(0), member(0), std::string("Proposal"), std::string("")));
+        run(app_call(N(addtspec), member(1), unfunded, golos::proposal_id_t(0), golos::tspec_id_t(0), member(1), make_tspec(0)));
+        for (size_t i = 0; i < witness_count_51; ++i)
+        {
+            const auto vote = app_call(N(votetspec), _delegates[i], unfunded, golos::proposal_id_t(0), golos::tspec_id_t(0),
+                                       _delegates[i], uint8_t(1), golos::comment_id_t(i), make_comment("I agree"));
+            if (i + 1 < witness_count_51)
+            {
+                run(vote);
+            }
+            else
+            {
+                eosio_assert(fails(vote), "technical specification is chosen without a fund");
+            }
+        }
+        const auto &failed = *worker::tspec_apps_t(code, unfunded).begin();
+        eosio_assert(__builtin_popcount(failed.votes.upvotes) == witness_count_51 - 1 &&
+                         failed.comments.comments.size() == witness_count_51 - 1,
+                     "the failed vote is written");
+    }
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    json_report = argc > 1 && std::string(argv[1]) == "--json";
+    native::now = 1500000000;
+
+    vector<call_t> pools;
+    for (size_t i = 0; i < proposals_count; ++i)
+    {
+        const account_name app = make_account("app", i);
+        pools.push_back(app_call(N(createpool), app, app, token_symbol, uint8_t(golos::state_t::COMMENTS_STORED)));
+    }
+
+    try
+    {
+        print_header();
+        measure("createpool", pools);
+
+        scenario_t scenario(make_account("golos", 0));
+        scenario.setup();
+        scenario.run_all();
+    }
+    catch (const native::assert_error &e)
+    {
+        fprintf(stderr, "assertion failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -15,6 +15,7 @@ for (let i = 0; i < 21; i++) {
 
 const tokenContractPrefix = "/opt/eosio/contracts/eosio.token/eosio.token";
 let tokenContract = null;
+let vestingContract = null;
 let contract = null;
 
 const STATE_TSPEC_APP = 1,
@@ -25,6 +26,9 @@ const STATE_TSPEC_APP = 1,
   STATE_PAYMENT = 6,
   STATE_CLOSED = 7;
 
+const OUTCOME_PAID = 1,
+  OUTCOME_REJECTED = 2;
+
 beforeEach(async done => {
   console.log("init");
   await eosTest.init();
@@ -34,6 +38,7 @@ beforeEach(async done => {
     ...delegateAccounts,
     "golos.worker",
     "eosio.token",
+    "golos.vest",
     appName
   );
 
@@ -66,6 +71,14 @@ beforeEach(async done => {
     `${tokenContractPrefix}.abi`
   );
 
+  // the vesting balances have the layout of the token balances
+  console.log("deploy a vesting contract");
+  vestingContract = await eosTest.deploy(
+    "golos.vest",
+    `${tokenContractPrefix}.wasm`,
+    `${tokenContractPrefix}.abi`
+  );
+
   console.log("build contract");
   await eosTest.make(".");
 
@@ -86,6 +99,21 @@ beforeEach(async done => {
     );
   }
 
+  console.log("create app vesting");
+  await vestingContract.create(appName, `1000000000 ${tokenSymbol}`, {
+    authorization: "golos.vest"
+  });
+  for (account of [appName, ...memberAccounts, ...delegateAccounts]) {
+    await vestingContract.issue(
+      account,
+      `1000000 ${tokenSymbol}`,
+      "member stake",
+      {
+        authorization: appName
+      }
+    );
+  }
+
   console.log("deploy golos.worker contract");
   contract = await eosTest.deploy(
     "golos.worker",
@@ -118,22 +146,37 @@ async function dumpState() {
   );
 }
 
-async function getProposal(proposalId) {
-  return (await eosTest.api.getTableRows(
+async function getRow(table, id) {
+  const row = (await eosTest.api.getTableRows(
     { json: true,
       code: "golos.worker",
       scope: appName,
-      table: "proposals",
-      lower_bound: proposalId,
+      table: table,
+      lower_bound: id,
       limit: 1
     })).rows[0];
+  return row && row.id === id ? row : undefined;
+}
+
+// closed proposals are moved to the propsummary table
+async function getProposal(proposalId) {
+  return getRow("proposals", proposalId);
+}
+
+async function getProposalSummary(proposalId) {
+  return getRow("propsummary", proposalId);
 }
 
 it(
   "1st use case test",
   async done => {
     console.log("create a workers pool");
-    await contract.createpool(appName, tokenSymbol, { authorization: appName });
+    await contract.createpool(appName, tokenSymbol, 0, { authorization: appName });
+
+    console.log("register delegates");
+    await contract.setdelegates(appName, delegateAccounts, {
+      authorization: appName
+    });
 
     console.log("Workers pool replenishment");
     await tokenContract.transfer(
@@ -256,6 +299,9 @@ it(
       await contract.votepropos(appName, proposal.id, delegateAccounts[1], 0, {
         authorization: delegateAccounts[1]
       });
+      const votes = (await getProposal(proposal.id)).votes;
+      expect(Number(votes.upvotes_weight)).toEqual(1000000);
+      expect(Number(votes.downvotes_weight)).toEqual(1000000);
 
       for (let comment of comments) {
         console.log("addcomment", comment);
@@ -269,6 +315,14 @@ it(
         );
       }
 
+      const proposalComments = (await eosTest.api.getTableRows(
+        true,
+        "golos.worker",
+        appName,
+        "comments"
+      )).rows.filter(row => row.proposal_id === proposal.id);
+      expect(proposalComments.length).toEqual(comments.length);
+
       for (let comment of comments) {
         console.log("editcomment", comment);
         await contract.editcomment(appName, proposal.id, comment.id, comment, {
@@ -379,13 +433,12 @@ it(
         await contract.withdraw(appName, proposal.id, {
           authorization: tspec.worker
         });
-      } while (
-        (await getProposal(proposal.id)).worker_payments_count !==
-        tspec.payments_count
-      );
+      } while (await getProposal(proposal.id));
 
-      console.log("check proposal state");
-      expect((await getProposal(proposal.id)).state).toEqual(STATE_CLOSED);
+      console.log("check proposal summary");
+      const summary = await getProposalSummary(proposal.id);
+      expect(summary.outcome).toEqual(OUTCOME_PAID);
+      expect(summary.worker).toEqual(tspec.worker);
     }
 
     done();
@@ -8,23 +8,45 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <map>
 
 #include "external.hpp"
 #include "structs.hpp"
+#include "rows.hpp"
 
 #include "app_dispatcher.hpp"
 
 using namespace eosio;
 
 #define TOKEN_ACCOUNT N(eosio.token)
+#define VESTING_ACCOUNT N(golos.vest)
 #define ZERO_ASSET asset(0, get_state().token_symbol)
-#define TIMESTAMP_UNDEFINED block_timestamp(0)
-#define TIMESTAMP_NOW block_timestamp(now())
 
 #define STRINGIFY(x) #x
 #define TOSTRING(x) STRINGIFY(x)
 #define ACCOUNT_NAME_CSTR(account_name) name{account_name}.to_string().c_str()
+
+// log levels, GOLOS_WORKER_LOG_LEVEL is set by the Makefile (LOG_LEVEL variable).
+// Disabled levels expand to nothing, so the arguments aren't evaluated
+#define GOLOS_WORKER_LOG_NONE 0
+#define GOLOS_WORKER_LOG_INFO 1
+#define GOLOS_WORKER_LOG_DEBUG 2
+
+#ifndef GOLOS_WORKER_LOG_LEVEL
+#define GOLOS_WORKER_LOG_LEVEL GOLOS_WORKER_LOG_NONE
+#endif
+
+#if GOLOS_WORKER_LOG_LEVEL >= GOLOS_WORKER_LOG_INFO
+#define LOG_INFO(format, ...) print_f("%(%): " format "\n", __FUNCTION__, ACCOUNT_NAME_CSTR(_app), ##__VA_ARGS__);
+#else
+#define LOG_INFO(format, ...)
+#endif
+
+#if GOLOS_WORKER_LOG_LEVEL >= GOLOS_WORKER_LOG_DEBUG
 #define LOG(format, ...) print_f("%(%): " format "\n", __FUNCTION__, ACCOUNT_NAME_CSTR(_app), ##__VA_ARGS__);
+#else
+#define LOG(format, ...)
+#endif
 
 namespace golos
 {
@@ -34,393 +56,513 @@ class worker : public contract
 {
 public:
   static constexpr uint32_t voting_time_s = 7 * 24 * 3600;
+  // the stake of a member is read from the vesting contract once an epoch
+  static constexpr uint32_t stake_epoch_s = 24 * 3600;
+
+  typedef multi_index<N(proposals), proposal_t,
+                      indexed_by<N(state), const_mem_fun<proposal_t, uint64_t, &proposal_t::by_state>>,
+                      indexed_by<N(author), const_mem_fun<proposal_t, uint64_t, &proposal_t::by_author>>,
+                      indexed_by<N(fund), const_mem_fun<proposal_t, uint64_t, &proposal_t::by_fund>>,
+                      indexed_by<N(created), const_mem_fun<proposal_t, uint64_t, &proposal_t::by_created>>,
+                      indexed_by<N(score), const_mem_fun<proposal_t, uint64_t, &proposal_t::by_score>>,
+                      indexed_by<N(deadline), const_mem_fun<proposal_t, uint64_t, &proposal_t::by_deadline>>>
+      proposals_t;
+  proposals_t _proposals;
 
-  typedef symbol_name app_domain_t;
-  typedef uint64_t comment_id_t;
+  typedef multi_index<N(propbodies), proposal_body_t> proposal_bodies_t;
+  proposal_bodies_t _proposal_bodies;
 
-  struct comment_data_t
-  {
-    string text;
+  typedef multi_index<N(propsummary), proposal_summary_t> proposal_summaries_t;
+  proposal_summaries_t _proposal_summaries;
 
-    EOSLIB_SERIALIZE(comment_data_t, (text));
-  };
+  // technical specification applications
+  typedef multi_index<N(tspecs), tspec_app_t,
+                      indexed_by<N(proposal), const_mem_fun<tspec_app_t, uint128_t, &tspec_app_t::by_proposal>>,
+                      indexed_by<N(upvotes), const_mem_fun<tspec_app_t, uint128_t, &tspec_app_t::by_upvotes>>>
+      tspec_apps_t;
+  tspec_apps_t _tspec_apps;
 
-  struct comment_t
-  {
-    comment_id_t id;
-    account_name author;
-    comment_data_t data;
-    block_timestamp created;
-    block_timestamp modified;
+  typedef multi_index<N(votes), vote_t,
+                      indexed_by<N(target), const_mem_fun<vote_t, key256, &vote_t::by_target>>>
+      votes_t;
+  votes_t _votes;
 
-    EOSLIB_SERIALIZE(comment_t, (id)(author)(data)(created)(modified));
-  };
+  typedef multi_index<N(stakes), stake_t> stakes_t;
+  stakes_t _stakes;
 
-  struct comments_module_t
-  {
-    vector<comment_t> comments;
+  typedef multi_index<N(accounts), vesting_balance_t> vesting_balances_t;
 
-    EOSLIB_SERIALIZE(comments_module_t, (comments));
+  typedef multi_index<N(comments), proposal_comment_t,
+                      indexed_by<N(proposal), const_mem_fun<proposal_comment_t, uint128_t, &proposal_comment_t::by_proposal>>,
+                      indexed_by<N(author), const_mem_fun<proposal_comment_t, uint64_t, &proposal_comment_t::by_author>>>
+      proposal_comments_t;
+  proposal_comments_t _proposal_comments;
 
-    void add(comment_id_t id, account_name author, const comment_data_t &data)
-    {
-      eosio_assert(std::find_if(comments.begin(), comments.end(), [&](const comment_t &comment) {
-                     return comment.id == id;
-                   }) == comments.end(),
-                   "comment with the same id is already exists");
-
-      comment_t comment{
-          .id = id,
-          .author = author,
-          .data = data,
-          .created = TIMESTAMP_NOW,
-          .modified = TIMESTAMP_UNDEFINED};
-
-      comments.push_back(comment);
-    }
+  singleton<N(states), state_t> _state;
+  singleton<N(delegates), delegate_registry_t> _delegates;
+  singleton<N(stats), stats_t> _stats;
+  singleton<N(statsbuild), stats_rebuild_t> _stats_rebuild;
 
-    auto lookup(comment_id_t id)
-    {
-      auto ptr = std::find_if(comments.begin(), comments.end(), [&](auto &o) {
-        return o.id == id;
-      });
+  typedef multi_index<N(funds), fund_t> funds_t;
+  funds_t _funds;
 
-      eosio_assert(ptr != comments.end(), "comment doesn't exist");
-      return ptr;
-    }
+  typedef multi_index<N(payouts), payout_t,
+                      indexed_by<N(due), const_mem_fun<payout_t, uint64_t, &payout_t::by_due>>>
+      payouts_t;
+  payouts_t _payouts;
 
-    const auto lookup(comment_id_t id) const
+  app_domain_t _app = 0;
+
+  /**
+   * @brief row_cache_t keeps copies of the rows that an action reads and modifies,
+   * every modified row is written back once by flush() when the action has succeeded
+   */
+  template <typename Table, typename T>
+  class row_cache_t
+  {
+    struct entry_t
     {
-      const auto ptr = std::find_if(comments.begin(), comments.end(), [&](auto &o) {
-        return o.id == id;
-      });
+      T row;
+      ///< the row in the table, multi_index keeps the loaded rows, so flush() doesn't look it up again
+      typename Table::const_iterator ptr;
+      account_name payer = 0;
+      bool dirty = false;
+    };
+
+    Table &_table;
+    std::map<uint64_t, entry_t> _entries;
+
+  public:
+    explicit row_cache_t(Table &table) : _table(table) {}
 
-      eosio_assert(ptr != comments.end(), "comment doesn't exist");
-      return ptr;
+    T &get(uint64_t key, const char *error_msg)
+    {
+      auto entry = _entries.find(key);
+      if (entry == _entries.end())
+      {
+        auto row = _table.find(key);
+        eosio_assert(row != _table.end(), error_msg);
+        entry = _entries.emplace(key, entry_t{*row, row}).first;
+      }
+      return entry->second.row;
     }
 
-    void del(comment_id_t id)
+    void modify(const T &row, account_name payer)
     {
-      auto comment_ptr = lookup(id);
-      eosio_assert(comment_ptr != comments.end(), "comment doens't exist");
-      require_auth(comment_ptr->author);
-      comments.erase(comment_ptr);
+      auto &entry = _entries.at(row.primary_key());
+      entry.payer = payer;
+      entry.dirty = true;
     }
 
-    void edit(comment_id_t id, const comment_data_t &data)
+    // drops the copy of a row that is erased from the table
+    void forget(uint64_t key)
     {
-      auto comment_ptr = lookup(id);
-      eosio_assert(comment_ptr != comments.end(), "comment doesn't exist");
-      require_auth(comment_ptr->author);
+      _entries.erase(key);
+    }
 
-      if (!data.text.empty())
+    void flush()
+    {
+      for (auto &entry : _entries)
       {
-        comment_ptr->data.text = data.text;
+        if (entry.second.dirty)
+        {
+          _table.modify(entry.second.ptr, entry.second.payer, [&](T &row) {
+            row = std::move(entry.second.row);
+          });
+        }
       }
+      _entries.clear();
     }
   };
 
-  typedef uint64_t tspec_id_t;
-
-  struct tspec_data_t
+  /**
+   * @brief batch_op_t is a single operation of the batch action
+   */
+  struct batch_op_t
   {
-    string text;
-    asset specification_cost;
-    block_timestamp specification_eta;
-    asset development_cost;
-    block_timestamp development_eta;
-    uint8_t payments_count;
+    enum type_t
+    {
+      OP_VOTEPROPOS = 1, ///< votepropos(proposal_id, author, value)
+      OP_ADDCOMMENT,     ///< addcomment(proposal_id, comment_id, author, comment)
+      OP_VOTETSPEC,      ///< votetspec(proposal_id, tspec_id, author, value, comment_id, comment)
+      OP_POSTSTATUS,     ///< poststatus(proposal_id, comment_id, comment, value)
+      OP_REVIEWWORK      ///< reviewwork(proposal_id, author, value, comment_id, comment)
+    };
 
-    EOSLIB_SERIALIZE(tspec_data_t, (text)(specification_cost)(specification_eta)(development_cost)(development_eta)(payments_count));
+    uint8_t type;
+    proposal_id_t proposal_id;
+    tspec_id_t tspec_id;
+    account_name author;
+    uint8_t value;
+    comment_id_t comment_id;
+    comment_data_t comment;
 
-    void update(const tspec_data_t &that)
-    {
-      if (!that.text.empty())
-      {
-        text = that.text;
-      }
-      if (that.specification_cost.amount != 0)
-      {
-        specification_cost = that.specification_cost;
-      }
+    EOSLIB_SERIALIZE(batch_op_t, (type)(proposal_id)(tspec_id)(author)(value)(comment_id)(comment));
+  };
 
-      if (that.specification_eta != TIMESTAMP_UNDEFINED)
-      {
-        specification_eta = that.specification_eta;
-      }
+  row_cache_t<proposals_t, proposal_t> _proposal_rows;
+  row_cache_t<proposal_bodies_t, proposal_body_t> _proposal_body_rows;
+  row_cache_t<tspec_apps_t, tspec_app_t> _tspec_rows;
+  row_cache_t<funds_t, fund_t> _fund_rows;
 
-      if (that.development_cost.amount != 0)
-      {
-        development_cost = that.development_cost;
-      }
+  state_t _state_row;
+  bool _state_loaded = false;
 
-      if (that.development_eta != TIMESTAMP_UNDEFINED)
-      {
-        development_eta = that.development_eta;
-      }
+  stats_t _stats_row;
+  bool _stats_loaded = false;
 
-      if (that.payments_count != 0)
-      {
-        payments_count = that.payments_count;
-      }
-    }
+  struct closed_proposal_t
+  {
+    proposal_summary_t summary;
+    account_name payer;
   };
 
-  struct voting_module_t
-  {
-    enum vote_value_t
-    {
-      VOTE_DOWN = 0,
-      VOTE_UP = 1
-    };
+  // proposals closed by the action, flush_rows() archives them
+  vector<closed_proposal_t> _closed_proposals;
 
-    set_t<account_name> upvotes;
-    set_t<account_name> downvotes;
+  // stakes of the members already checked by the action
+  std::map<account_name, int64_t> _member_stakes;
 
-    bool upvoted(account_name voter)
+protected:
+  const state_t &get_state()
+  {
+    if (!_state_loaded)
     {
-      return upvotes.has(voter);
+      _state_row = _state.get();
+      _state_loaded = true;
     }
+    return _state_row;
+  }
+
+  auto get_delegates()
+  {
+    return _delegates.get_or_default(delegate_registry_t{});
+  }
+
+  stats_t make_stats()
+  {
+    return stats_t{
+        .proposals = vector<uint32_t>(proposal_t::STATE_CLOSED + 1),
+        .closed_count = 0,
+        .funds = ZERO_ASSET,
+        .deposits = ZERO_ASSET,
+        .transferred = ZERO_ASSET,
+        .tspec_author_paid = ZERO_ASSET,
+        .worker_paid = ZERO_ASSET,
+        .refunded = ZERO_ASSET};
+  }
 
-    bool downvoted(account_name voter)
+  // the statistics are read once and written by flush_rows() when the action has succeeded
+  stats_t &modify_stats()
+  {
+    if (!_stats_loaded)
     {
-      return downvotes.has(voter);
+      _stats_row = _stats.get_or_default(make_stats());
+      _stats_loaded = true;
     }
+    return _stats_row;
+  }
 
-    void upvote(account_name voter)
+  // the statistics of a pool created before them start without the existing proposals,
+  // the counters stop at 0 until rebuildstats recounts them
+  static void count_down(uint32_t &counter)
+  {
+    if (counter > 0)
     {
-      eosio_assert(!upvotes.has(voter), "already upvoted");
-      eosio_assert(!downvotes.has(voter), "already downvoted");
-      upvotes.set(voter);
+      counter -= 1;
     }
+  }
 
-    void downvote(account_name voter)
+  void set_proposal_state(proposal_t &proposal, proposal_t::state_t state)
+  {
+    auto &stats = modify_stats();
+    count_down(stats.proposals[proposal.state]);
+    if (state == proposal_t::STATE_CLOSED)
     {
-      eosio_assert(!upvotes.has(voter), "already upvoted");
-      eosio_assert(!downvotes.has(voter), "already downvoted");
-      downvotes.set(voter);
+      stats.closed_count += 1;
     }
-
-    void vote(account_name voter, vote_value_t vote)
+    else
     {
-      switch (vote)
-      {
-      case VOTE_UP:
-        upvote(voter);
-        break;
-      case VOTE_DOWN:
-        downvote(voter);
-        break;
-      default:
-        eosio_assert(false, "invalid vote argument");
-      }
+      stats.proposals[state] += 1;
     }
+    proposal.set_state(state);
+  }
 
-    void delvote(account_name voter)
+  /**
+   * @brief keep_comment returns the comment data to keep in the tables. In the COMMENTS_HASHED mode
+   * the tables keep only the sha256 of the text, the commented event binds it to the comment
+   * @param text_hash set to the sha256 of the text in the COMMENTS_HASHED mode
+   */
+  comment_data_t keep_comment(comment_t::target_type_t target_type, uint64_t target_id, comment_id_t comment_id,
+                              account_name author, const comment_data_t &data, checksum256 &text_hash)
+  {
+    text_hash = checksum256{};
+    if (get_state().comment_mode != state_t::COMMENTS_HASHED)
     {
-      upvotes.unset(voter);
-      downvotes.unset(voter);
+      return data;
     }
 
-    EOSLIB_SERIALIZE(voting_module_t, (upvotes)(downvotes));
-  };
+    sha256(data.text.data(), data.text.size(), &text_hash);
+    action(permission_level{_self, N(active)},
+           _self, N(commented),
+           std::make_tuple(_app, uint8_t(target_type), target_id, comment_id, author, text_hash))
+        .send();
+    return comment_data_t{};
+  }
 
-  struct tspec_app_t
+  // votes for something created at the given time are accepted until this deadline,
+  // TIMESTAMP_NOW keeps the seconds of now() in the slot
+  static uint32_t voting_deadline(block_timestamp created)
   {
-    tspec_id_t id;
-    account_name author;
-
-    tspec_data_t data;
-
-    voting_module_t votes;
-    comments_module_t comments;
-
-    block_timestamp created;
-    block_timestamp modified;
+    return created.slot + voting_time_s;
+  }
 
-    EOSLIB_SERIALIZE(tspec_app_t, (id)(author)(data)(votes)(comments)(created)(modified));
+  stakes_t &get_stakes()
+  {
+    return _stakes;
+  }
 
-    void modify(const tspec_data_t &that)
+  /**
+   * @brief snapshot_stake reads the vesting balance of the account and stores it as the stake of the current epoch
+   * @param stake_ptr the snapshot of the account or the end of the table
+   * @param payer payer of a new snapshot, an existing snapshot keeps its payer
+   */
+  int64_t snapshot_stake(stakes_t::const_iterator stake_ptr, account_name account, account_name payer)
+  {
+    vesting_balances_t balances(VESTING_ACCOUNT, account);
+    auto balance_ptr = balances.find(symbol_type(get_state().token_symbol).name());
+    const int64_t weight = balance_ptr != balances.end() ? balance_ptr->balance.amount : 0;
+
+    auto update = [&](stake_t &stake) {
+      stake.member = account;
+      stake.weight = weight;
+      stake.epoch = now() / stake_epoch_s;
+    };
+    if (stake_ptr == get_stakes().end())
     {
-      data.update(that);
-      modified = TIMESTAMP_NOW;
+      get_stakes().emplace(payer, update);
+    }
+    else
+    {
+      get_stakes().modify(stake_ptr, 0, update);
     }
-  };
 
-  typedef uint64_t proposal_id_t;
+    _member_stakes[account] = weight;
+    return weight;
+  }
 
-  //@abi table proposals i64
-  struct proposal_t
+  /**
+   * @brief get_stake returns the vesting balance of the account taken at its first vote or application in the current epoch,
+   * the vesting contract is read only when the snapshot is missing or older than the epoch,
+   * the snapshot is read once an action
+   */
+  int64_t get_stake(account_name account)
   {
-    enum state_t
+    auto checked_ptr = _member_stakes.find(account);
+    if (checked_ptr != _member_stakes.end())
     {
-      STATE_TSPEC_APP = 1,
-      STATE_TSPEC_CREATE,
-      STATE_WORK,
-      STATE_TSPEC_AUTHOR_REVIEW,
-      STATE_DELEGATES_REVIEW,
-      STATE_PAYMENT,
-      STATE_CLOSED
-    };
+      return checked_ptr->second;
+    }
 
-    enum review_status_t
+    auto stake_ptr = get_stakes().find(account);
+    if (stake_ptr != get_stakes().end() && stake_ptr->epoch == now() / stake_epoch_s)
     {
-      STATUS_REJECT = 0,
-      STATUS_ACCEPT = 1
-    };
+      _member_stakes[account] = stake_ptr->weight;
+      return stake_ptr->weight;
+    }
+    return snapshot_stake(stake_ptr, account, account);
+  }
 
-    enum type_t
-    {
-      TYPE_1,
-      TYPE_2
-    };
+  void require_app_member(account_name account)
+  {
+    require_auth(account);
+  }
 
-    proposal_id_t id;
-    account_name author;
-    uint8_t type;
-    string title;
-    string description;
-    account_name fund_name;
-    asset deposit;
-    voting_module_t votes;
-    comments_module_t comments;
-    // technical specification applications
-    vector<tspec_app_t> tspec_apps;
-    ///< technical specification author
-    account_name tspec_author;
-    ///< technical specification data
-    tspec_data_t tspec;
-    ///< perpetrator account name
-    account_name worker;
-    block_timestamp work_begining_time;
-    comments_module_t work_status;
-    uint8_t worker_payments_count;
-
-    voting_module_t review_votes;
-
-    block_timestamp created;
-    block_timestamp modified;
-    uint8_t state;
-
-    EOSLIB_SERIALIZE(proposal_t, (id)(author)(type)(title)(description)(fund_name)(deposit)(votes)(comments)(tspec_apps)(tspec_author)(tspec)(worker)(work_begining_time)(work_status)(worker_payments_count)(review_votes)(created)(modified)(state));
-
-    uint64_t primary_key() const { return id; }
-    void set_state(state_t new_state) { state = new_state; }
-  };
+  /**
+   * @brief require_staked_member checks the authority and the stake of the account, the stake is required
+   * where it weighs: the votes for the proposals and the applications
+   * @return stake of the account, the weight of its votes
+   */
+  int64_t require_staked_member(account_name account)
+  {
+    require_app_member(account);
+    const int64_t stake = get_stake(account);
+    eosio_assert(stake > 0, "app domain member authority is required to do this action");
+    return stake;
+  }
 
-  typedef multi_index<N(proposals), proposal_t> proposals_t;
-  proposals_t _proposals;
+  uint8_t require_app_delegate(const delegate_registry_t &delegates, account_name account)
+  {
+    require_auth(account);
+    const int slot = delegates.find_slot(account);
+    eosio_assert(slot >= 0 && (delegates.active_mask & (1u << slot)), "app domain delegate authority is required to do this action");
+    return slot;
+  }
 
-  //@abi table states i64
-  struct state_t
+  proposals_t &get_proposals()
   {
-    symbol_name token_symbol;
+    return _proposals;
+  }
 
-    EOSLIB_SERIALIZE(state_t, (token_symbol));
+  proposal_t &get_proposal(proposal_id_t proposal_id)
+  {
+    return _proposal_rows.get(proposal_id, "proposal has not been found");
+  }
 
-    uint64_t primary_key() const { return 0; }
-  };
+  proposal_bodies_t &get_proposal_bodies()
+  {
+    return _proposal_bodies;
+  }
 
-  singleton<N(states), state_t> _state;
+  proposal_body_t &get_proposal_body(proposal_id_t proposal_id)
+  {
+    return _proposal_body_rows.get(proposal_id, "proposal has not been found");
+  }
 
-  //@abi table funds i64
-  struct fund_t
+  proposal_summaries_t &get_proposal_summaries()
   {
-    account_name owner;
-    asset quantity;
+    return _proposal_summaries;
+  }
 
-    EOSLIB_SERIALIZE(fund_t, (owner)(quantity));
+  // the comments and the votes of a closed proposal are kept for the retention period of the pool,
+  // TIMESTAMP_NOW keeps the seconds of now() in the slot
+  bool retention_over(const proposal_summary_t &summary)
+  {
+    return uint64_t(summary.closed.slot) + get_state().retention_s <= now();
+  }
 
-    uint64_t primary_key() const { return owner; }
-  };
+  void require_new_proposal_id(proposal_id_t proposal_id)
+  {
+    eosio_assert(get_proposal_summaries().find(proposal_id) == get_proposal_summaries().end(),
+                 "proposal with the same id has been closed");
+  }
 
-  typedef multi_index<N(funds), fund_t> funds_t;
-  funds_t _funds;
+  proposal_comments_t &get_proposal_comments()
+  {
+    return _proposal_comments;
+  }
 
-  app_domain_t _app = 0;
+  const auto &get_proposal_comment(proposal_id_t proposal_id, comment_id_t comment_id)
+  {
+    auto index = get_proposal_comments().get_index<N(proposal)>();
+    auto comment_ptr = index.find(proposal_comment_t::make_key(proposal_id, comment_id));
+    eosio_assert(comment_ptr != index.end(), "comment doesn't exist");
+    return *comment_ptr;
+  }
 
-protected:
-  auto get_state()
+  votes_t &get_votes()
   {
-    return _state.get();
+    return _votes;
   }
 
-  void require_app_member(account_name account)
+  void add_vote(vote_t::target_type_t target_type, uint64_t target_id, account_name voter, voting_module_t::vote_value_t value)
   {
-    require_auth(account);
-    //TODO: eosio_assert(golos.vest::get_balance(account, _app).amount > 0, "app domain member authority is required to do this action");
+    eosio_assert(value == voting_module_t::VOTE_UP || value == voting_module_t::VOTE_DOWN, "invalid vote argument");
+
+    auto index = get_votes().get_index<N(target)>();
+    auto vote_ptr = index.find(vote_t::make_key(target_type, target_id, voter));
+    if (vote_ptr != index.end())
+    {
+      eosio_assert(false, vote_ptr->value == voting_module_t::VOTE_UP ? "already upvoted" : "already downvoted");
+    }
+
+    get_votes().emplace(voter, [&](vote_t &vote) {
+      vote.id = get_votes().available_primary_key();
+      vote.target_type = target_type;
+      vote.target_id = target_id;
+      vote.voter = voter;
+      vote.value = value;
+      vote.created = TIMESTAMP_NOW;
+    });
   }
 
-  void require_app_delegate(account_name account)
+  funds_t &get_funds()
   {
-    require_auth(account);
-    //TODO: eosio_assert(golos.ctrl::is_witness(account, _app), "app domain delegate authority is required to do this action");
+    return _funds;
   }
 
-  proposals_t &get_proposals()
+  fund_t &get_fund(account_name fund_name)
   {
-    return _proposals;
+    return _fund_rows.get(fund_name, "fund doesn't exists");
   }
 
-  const auto get_proposal(proposal_id_t proposal_id)
+  payouts_t &get_payouts()
   {
-    auto proposal = get_proposals().find(proposal_id);
-    eosio_assert(proposal != get_proposals().end(), "proposal has not been found");
-    return proposal;
+    return _payouts;
   }
 
-  funds_t &get_funds()
+  tspec_apps_t &get_tspec_apps()
   {
-    return _funds;
+    return _tspec_apps;
   }
 
-  auto get_fund(account_name fund_name)
+  const auto &get_tspec(proposal_id_t proposal_id, tspec_id_t tspec_app_id)
   {
-    auto fund_ptr = get_funds().find(fund_name);
-    eosio_assert(fund_ptr != get_funds().end(), "fund doesn't exists");
-    return fund_ptr;
+    auto index = get_tspec_apps().get_index<N(proposal)>();
+    auto tspec_ptr = index.find(tspec_app_t::make_key(proposal_id, tspec_app_id));
+    eosio_assert(tspec_ptr != index.end(), "technical specification doesn't exist");
+    return *tspec_ptr;
   }
 
-  inline auto get_tspec(proposal_t &proposal, tspec_id_t tspec_app_id)
+  tspec_app_t &get_tspec_app(proposal_id_t proposal_id, tspec_id_t tspec_app_id)
   {
-    return std::find_if(proposal.tspec_apps.begin(), proposal.tspec_apps.end(), [&](const auto &o) {
-      return o.id == tspec_app_id;
-    });
+    return _tspec_rows.get(get_tspec(proposal_id, tspec_app_id).id, "technical specification doesn't exist");
   }
 
-  inline const auto get_tspec(const proposal_t &proposal, tspec_id_t tspec_app_id)
+  /**
+   * @brief prune_tspec_apps erases the technical specification applications of the proposal while the budget lasts
+   * @param budget number of the rows that can be erased, decreased by the erased rows
+   * @return true if no applications of the proposal are left
+   */
+  bool prune_tspec_apps(proposal_id_t proposal_id, uint32_t &budget)
   {
-    return std::find_if(proposal.tspec_apps.begin(), proposal.tspec_apps.end(), [&](const auto &o) {
-      return o.id == tspec_app_id;
-    });
+    auto index = get_tspec_apps().get_index<N(proposal)>();
+    auto tspec_ptr = index.lower_bound(tspec_app_t::make_key(proposal_id, 0));
+    while (tspec_ptr != index.end() && tspec_ptr->proposal_id == proposal_id)
+    {
+      if (budget == 0)
+      {
+        return false;
+      }
+      _tspec_rows.forget(tspec_ptr->id);
+      tspec_ptr = index.erase(tspec_ptr);
+      budget--;
+    }
+    return true;
   }
 
-  void choose_proposal_tspec(proposal_t &proposal, tspec_app_t &tspec_app, account_name modifier)
+  void choose_proposal_tspec(proposal_t &proposal, const tspec_app_t &tspec_app, account_name modifier)
   {
     if (proposal.deposit.amount == 0)
     {
       const asset budget = tspec_app.data.development_cost + tspec_app.data.specification_cost;
-      auto fund = get_funds().find(proposal.fund_name);
-      eosio_assert(fund != get_funds().end(), "fund doens't exist");
-      LOG("tspec_app: % budget: %, fund: %", tspec_app.id, budget, fund->quantity);
-      eosio_assert(budget <= fund->quantity, "insufficient funds");
+      auto &fund = get_fund(proposal.fund_name);
+      LOG_INFO("tspec_app: % budget: %, fund: %", tspec_app.id, budget, fund.quantity);
+      eosio_assert(budget <= fund.quantity, "insufficient funds");
 
       proposal.deposit = budget;
-      get_funds().modify(fund, modifier, [&](auto &fund) {
-        fund.quantity -= budget;
-      });
+      fund.quantity -= budget;
+      _fund_rows.modify(fund, modifier);
+
+      auto &stats = modify_stats();
+      stats.funds -= budget;
+      stats.deposits += budget;
     }
 
     proposal.tspec_author = tspec_app.author;
-    proposal.tspec = tspec_app.data;
+    proposal.tspec.set(tspec_app.data);
+
+    auto &body = get_proposal_body(proposal.id);
+    body.tspec_text = tspec_app.data.text;
+    _proposal_body_rows.modify(body, modifier);
 
     if (proposal.type == proposal_t::TYPE_1)
     {
-      proposal.set_state(proposal_t::STATE_TSPEC_CREATE);
+      set_proposal_state(proposal, proposal_t::STATE_TSPEC_CREATE);
     }
     else
     {
-      proposal.set_state(proposal_t::STATE_DELEGATES_REVIEW);
+      set_proposal_state(proposal, proposal_t::STATE_DELEGATES_REVIEW);
       proposal.worker = proposal.tspec_author;
     }
   }
@@ -428,9 +570,13 @@ protected:
   void pay_tspec_author(proposal_t &proposal)
   {
 
-    LOG("paying % to %", proposal.tspec.specification_cost, ACCOUNT_NAME_CSTR(proposal.tspec_author));
+    LOG_INFO("paying % to %", proposal.tspec.specification_cost, ACCOUNT_NAME_CSTR(proposal.tspec_author));
     proposal.deposit -= proposal.tspec.specification_cost;
 
+    auto &stats = modify_stats();
+    stats.deposits -= proposal.tspec.specification_cost;
+    stats.tspec_author_paid += proposal.tspec.specification_cost;
+
     action(permission_level{_self, N(active)},
            TOKEN_ACCOUNT, N(transfer),
            std::make_tuple(_self, proposal.tspec_author,
@@ -439,50 +585,443 @@ protected:
         .send();
   }
 
+  // the payments vest from now to the development deadline
+  void fix_payment_schedule(proposal_t &proposal)
+  {
+    const uint32_t deadline = proposal.tspec.development_eta.to_time_point().sec_since_epoch();
+    auto &schedule = proposal.payment_schedule;
+    schedule.start = now();
+    schedule.duration_s = deadline > schedule.start ? deadline - schedule.start : 0;
+    schedule.total = proposal.tspec.development_cost;
+  }
+
   void enable_worker_reward(proposal_t &proposal)
   {
-    proposal.set_state(proposal_t::STATE_PAYMENT);
+    set_proposal_state(proposal, proposal_t::STATE_PAYMENT);
+
+    // the proposals for the done work skip startwork
+    if (proposal.payment_schedule.start == 0)
+    {
+      fix_payment_schedule(proposal);
+    }
+
+    get_payouts().emplace(_self, [&](payout_t &payout) {
+      payout.proposal_id = proposal.id;
+      payout.due = payment_due_time(proposal);
+    });
+  }
+
+  // number of the payments vested by now, a single payment vests at once
+  uint8_t vested_payments(const proposal_t &proposal)
+  {
+    const auto &schedule = proposal.payment_schedule;
+    const uint8_t payments_count = proposal.tspec.payments_count;
+    const uint32_t elapsed = now() - schedule.start;
+    if (payments_count == 1 || elapsed >= schedule.duration_s)
+    {
+      return payments_count;
+    }
+    return uint64_t(elapsed) * payments_count / schedule.duration_s;
+  }
+
+  // sum of the first payments, the last one picks up the remainder of the division
+  asset scheduled_amount(const proposal_t &proposal, uint8_t payments)
+  {
+    const auto &total = proposal.payment_schedule.total;
+    if (payments == proposal.tspec.payments_count)
+    {
+      return total;
+    }
+    return asset(total.amount / proposal.tspec.payments_count * payments, total.symbol);
+  }
+
+  bool is_payment_due(const proposal_t &proposal)
+  {
+    const uint8_t vested = vested_payments(proposal);
+    LOG("vested payments: %, worker payments: %", int(vested), int(proposal.worker_payments_count));
+    return vested > proposal.worker_payments_count;
+  }
+
+  // orders the payout queue by the time the next payment vests
+  uint64_t payment_due_time(const proposal_t &proposal)
+  {
+    const auto &schedule = proposal.payment_schedule;
+    const uint8_t payments_count = proposal.tspec.payments_count;
+    if (payments_count == 1)
+    {
+      return 0;
+    }
+    const uint64_t next = proposal.worker_payments_count + 1;
+    return schedule.start + (uint64_t(schedule.duration_s) * next + payments_count - 1) / payments_count;
+  }
+
+  /**
+   * @brief pay_worker takes all the vested payments from the deposit, closes the proposal after the last one
+   * and moves the proposal in the payout queue
+   * @param payer payer of the summary of the closed proposal, an account that has authorized the action
+   * @return amount to transfer to the worker
+   */
+  asset pay_worker(proposal_t &proposal, account_name payer)
+  {
+    const uint8_t vested = vested_payments(proposal);
+    const asset quantity = scheduled_amount(proposal, vested) - scheduled_amount(proposal, proposal.worker_payments_count);
+
+    proposal.deposit -= quantity;
+    proposal.worker_payments_count = vested;
+
+    auto &stats = modify_stats();
+    stats.deposits -= quantity;
+    stats.worker_paid += quantity;
+
+    const auto &payout = get_payouts().get(proposal.id, "payment isn't scheduled");
+    if (proposal.worker_payments_count == proposal.tspec.payments_count)
+    {
+      close(proposal, get_delegates(), proposal_summary_t::OUTCOME_PAID, ZERO_ASSET, payer);
+      get_payouts().erase(payout);
+    }
+    else
+    {
+      get_payouts().modify(payout, _self, [&](payout_t &payout) {
+        payout.due = payment_due_time(proposal);
+      });
+    }
+
+    return quantity;
   }
 
   void refund(proposal_t &proposal, account_name modifier)
   {
     eosio_assert(proposal.deposit.amount > 0, "no funds were deposited");
 
-    auto fund_ptr = get_fund(proposal.fund_name);
-    LOG("% to % fund", proposal.deposit, ACCOUNT_NAME_CSTR(fund_ptr->owner));
-    get_funds().modify(fund_ptr, modifier, [&](auto &fund) {
-      fund.quantity += proposal.deposit;
-    });
+    auto &fund = get_fund(proposal.fund_name);
+    LOG_INFO("% to % fund", proposal.deposit, ACCOUNT_NAME_CSTR(fund.owner));
+    fund.quantity += proposal.deposit;
+    _fund_rows.modify(fund, modifier);
+
+    auto &stats = modify_stats();
+    stats.funds += proposal.deposit;
+    stats.deposits -= proposal.deposit;
+    stats.refunded += proposal.deposit;
 
     proposal.deposit = ZERO_ASSET;
   }
 
-  void close(proposal_t &proposal)
+  void close(proposal_t &proposal, const delegate_registry_t &delegates,
+             proposal_summary_t::outcome_t outcome, const asset &refunded, account_name payer)
+  {
+    set_proposal_state(proposal, proposal_t::STATE_CLOSED);
+
+    const bool paid = outcome == proposal_summary_t::OUTCOME_PAID;
+    _closed_proposals.push_back(closed_proposal_t{
+        .summary = proposal_summary_t{
+            .id = proposal.id,
+            .author = proposal.author,
+            .type = proposal.type,
+            .outcome = (uint8_t)outcome,
+            .fund_name = proposal.fund_name,
+            .tspec_author = proposal.tspec_author,
+            .worker = proposal.worker,
+            .tspec_author_paid = paid ? proposal.tspec.specification_cost : ZERO_ASSET,
+            .worker_paid = paid ? proposal.tspec.development_cost : ZERO_ASSET,
+            .refunded = refunded,
+            .votes = proposal.votes,
+            .review_upvotes = (uint8_t)proposal.review_votes.upvotes_count(delegates.active_mask),
+            .review_downvotes = (uint8_t)proposal.review_votes.downvotes_count(delegates.active_mask),
+            .content_hash = {},
+            .created = proposal.created,
+            .closed = TIMESTAMP_NOW},
+        .payer = payer});
+  }
+
+  /**
+   * @brief prune_proposal erases the technical specification applications, the comments and the votes of the proposal
+   * while the budget lasts
+   * @param budget number of the rows that can be erased, decreased by the erased rows
+   * @return true if no applications, comments and votes of the proposal are left
+   */
+  bool prune_proposal(proposal_id_t proposal_id, uint32_t &budget)
+  {
+    if (!prune_tspec_apps(proposal_id, budget))
+    {
+      return false;
+    }
+
+    auto comments_index = get_proposal_comments().get_index<N(proposal)>();
+    auto comment_ptr = comments_index.lower_bound(proposal_comment_t::make_key(proposal_id, 0));
+    while (comment_ptr != comments_index.end() && comment_ptr->proposal_id == proposal_id)
+    {
+      if (budget == 0)
+      {
+        return false;
+      }
+      comment_ptr = comments_index.erase(comment_ptr);
+      budget--;
+    }
+
+    auto votes_index = get_votes().get_index<N(target)>();
+    auto vote_ptr = votes_index.lower_bound(vote_t::make_key(vote_t::TARGET_PROPOSAL, proposal_id, 0));
+    while (vote_ptr != votes_index.end() &&
+           vote_ptr->target_type == vote_t::TARGET_PROPOSAL && vote_ptr->target_id == proposal_id)
+    {
+      if (budget == 0)
+      {
+        return false;
+      }
+      vote_ptr = votes_index.erase(vote_ptr);
+      budget--;
+    }
+    return true;
+  }
+
+  /**
+   * @brief archive_closed_proposals replaces the proposals closed by the action with their summaries.
+   * The summary with the hash of the body is sent in the propclosed action, the body and the header are erased,
+   * the applications are left to cleanup with the comments and the votes. The body is read to be erased anyway,
+   * its text is in the history of the actions that have written it
+   */
+  void archive_closed_proposals()
+  {
+    for (auto &closed : _closed_proposals)
+    {
+      const proposal_id_t proposal_id = closed.summary.id;
+      const auto &body = get_proposal_body(proposal_id);
+
+      const auto packed_body = pack(body);
+      sha256(packed_body.data(), packed_body.size(), &closed.summary.content_hash);
+
+      // a fixed-size event, the body doesn't fit the inline action size limit
+      action(permission_level{_self, N(active)},
+             _self, N(propclosed),
+             std::make_tuple(_app, closed.summary))
+          .send();
+
+      get_proposal_summaries().emplace(closed.payer, [&](proposal_summary_t &summary) {
+        summary = closed.summary;
+      });
+
+      _proposal_body_rows.forget(proposal_id);
+      get_proposal_bodies().erase(get_proposal_bodies().get(proposal_id, "proposal has not been found"));
+
+      _proposal_rows.forget(proposal_id);
+      get_proposals().erase(get_proposals().get(proposal_id, "proposal has not been found"));
+    }
+    _closed_proposals.clear();
+  }
+
+  void vote_proposal(proposal_id_t proposal_id, account_name author, uint8_t vote)
+  {
+    auto &proposal = get_proposal(proposal_id);
+    eosio_assert(voting_deadline(proposal.created) >= now(), "voting time is over");
+    const int64_t stake = require_staked_member(author);
+
+    add_vote(vote_t::TARGET_PROPOSAL, proposal_id, author, static_cast<voting_module_t::vote_value_t>(vote));
+
+    proposal.votes.add(static_cast<voting_module_t::vote_value_t>(vote), stake);
+    _proposal_rows.modify(proposal, author);
+  }
+
+  void add_comment(proposal_id_t proposal_id, comment_id_t comment_id, account_name author, const comment_data_t &data)
   {
-    proposal.set_state(proposal_t::STATE_CLOSED);
+    LOG("proposal_id: %, comment_id: %, author: %", proposal_id, comment_id, ACCOUNT_NAME_CSTR(author));
+    get_proposal(proposal_id);
+    require_app_member(author);
+
+    auto index = get_proposal_comments().get_index<N(proposal)>();
+    eosio_assert(index.find(proposal_comment_t::make_key(proposal_id, comment_id)) == index.end(),
+                 "comment with the same id is already exists");
+
+    checksum256 text_hash;
+    const auto kept = keep_comment(comment_t::TARGET_PROPOSAL, proposal_id, comment_id, author, data, text_hash);
+
+    get_proposal_comments().emplace(author, [&](auto &comment) {
+      comment.id = get_proposal_comments().available_primary_key();
+      comment.proposal_id = proposal_id;
+      comment.comment_id = comment_id;
+      comment.author = author;
+      comment.data = kept;
+      comment.text_hash = text_hash;
+      comment.created = TIMESTAMP_NOW;
+      comment.modified = TIMESTAMP_UNDEFINED;
+    });
+  }
+
+  void vote_tspec(const delegate_registry_t &delegates, proposal_id_t proposal_id, tspec_id_t tspec_app_id,
+                  account_name author, uint8_t vote, comment_id_t comment_id, const comment_data_t &comment)
+  {
+    LOG("proposal_id: %, tpsec_id: %, author: %, vote: %", proposal_id, tspec_app_id, ACCOUNT_NAME_CSTR(author), (int)vote);
+
+    auto &proposal = get_proposal(proposal_id);
+    eosio_assert(proposal.state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
+    eosio_assert(proposal.type == proposal_t::TYPE_1, "unsupported action");
+
+    auto &tspec_app = get_tspec_app(proposal_id, tspec_app_id);
+    const uint8_t slot = require_app_delegate(delegates, author);
+    // an application is voted until its own deadline, if the proposal hasn't expired before
+    eosio_assert(voting_deadline(tspec_app.created) >= now(), "voting time is over");
+    eosio_assert(proposal.voting_deadline >= now(), "proposal has expired");
+
+    tspec_app.votes.vote(delegates, slot, static_cast<voting_module_t::vote_value_t>(vote));
+    if (!comment.text.empty())
+    {
+      checksum256 text_hash;
+      const auto kept = keep_comment(comment_t::TARGET_TSPEC_APP, tspec_app.id, comment_id, author, comment, text_hash);
+      tspec_app.comments.add(comment_id, author, kept, text_hash);
+    }
+    _tspec_rows.modify(tspec_app, author);
+
+    switch (vote)
+    {
+    case voting_module_t::VOTE_UP:
+      if (tspec_app.votes.upvotes_count(delegates.active_mask) >= witness_count_51)
+      {
+        // the other applications lose with the state of the proposal, the vote doesn't erase them, so it costs
+        // the same for any number of them. expire, delpropos and cleanup erase them in bounded batches
+        choose_proposal_tspec(proposal, tspec_app, author);
+        _proposal_rows.modify(proposal, author);
+      }
+      break;
+    case voting_module_t::VOTE_DOWN:
+      break;
+    }
+  }
+
+  void post_status(proposal_id_t proposal_id, comment_id_t comment_id, const comment_data_t &comment, bool finished)
+  {
+    LOG("proposal_id: %, comment: %, final: %", proposal_id, comment.text.c_str(), (int) finished);
+    auto &proposal = get_proposal(proposal_id);
+    eosio_assert(proposal.state == proposal_t::STATE_WORK, "invalid proposal state");
+    eosio_assert(proposal.type == proposal_t::TYPE_1, "unsupported action");
+    require_auth(proposal.worker);
+
+    checksum256 text_hash;
+    const auto kept = keep_comment(comment_t::TARGET_WORK_STATUS, proposal_id, comment_id, proposal.worker, comment, text_hash);
+
+    auto &body = get_proposal_body(proposal_id);
+    body.work_status.add(comment_id, proposal.worker, kept, text_hash);
+    _proposal_body_rows.modify(body, proposal.worker);
+
+    if (finished)
+    {
+      set_proposal_state(proposal, proposal_t::STATE_TSPEC_AUTHOR_REVIEW);
+      _proposal_rows.modify(proposal, proposal.worker);
+    }
+  }
+
+  void review_work(const delegate_registry_t &delegates, proposal_id_t proposal_id, account_name reviewer,
+                   uint8_t status, comment_id_t comment_id, const comment_data_t &comment)
+  {
+    LOG("proposal_id: %, comment: %, status: %, reviewer: %", proposal_id, comment.text.c_str(), (int) status, ACCOUNT_NAME_CSTR(reviewer));
+    const uint8_t slot = require_app_delegate(delegates, reviewer);
+    auto &proposal = get_proposal(proposal_id);
+
+    switch (status)
+    {
+    case proposal_t::STATUS_REJECT:
+      eosio_assert(proposal.state == proposal_t::STATE_DELEGATES_REVIEW ||
+                       proposal.state == proposal_t::STATE_WORK ||
+                       proposal.state == proposal_t::STATE_TSPEC_AUTHOR_REVIEW,
+                   "invalid state " __FILE__ ":" TOSTRING(__LINE__));
+
+      proposal.review_votes.vote(delegates, slot, voting_module_t::VOTE_DOWN);
+
+      if (proposal.review_votes.downvotes_count(delegates.active_mask) >= wintess_count_75)
+      {
+        LOG_INFO("work has been rejected by the delegates voting, got % negative votes", proposal.review_votes.downvotes_count(delegates.active_mask));
+        const asset refunded = proposal.deposit;
+        refund(proposal, reviewer);
+        close(proposal, delegates, proposal_summary_t::OUTCOME_REJECTED, refunded, reviewer);
+      }
+      break;
+
+    case proposal_t::STATUS_ACCEPT:
+      eosio_assert(proposal.state == proposal_t::STATE_DELEGATES_REVIEW, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
+      proposal.review_votes.vote(delegates, slot, voting_module_t::VOTE_UP);
+      if (proposal.review_votes.upvotes_count(delegates.active_mask) >= witness_count_51)
+      {
+        LOG_INFO("work has been accepted by the delegates voting, got % positive votes", proposal.review_votes.upvotes_count(delegates.active_mask));
+        pay_tspec_author(proposal);
+        enable_worker_reward(proposal);
+      }
+
+      break;
+
+    default:
+      eosio_assert(false, "invalid review status");
+    }
+
+    _proposal_rows.modify(proposal, reviewer);
   }
 
 public:
   worker(account_name owner, app_domain_t app) : contract(owner),
                                                  _app(app),
                                                  _state(_self, app),
+                                                 _delegates(_self, app),
+                                                 _stats(_self, app),
+                                                 _stats_rebuild(_self, app),
                                                  _proposals(_self, app),
-                                                 _funds(_self, app)
+                                                 _proposal_bodies(_self, app),
+                                                 _proposal_summaries(_self, app),
+                                                 _tspec_apps(_self, app),
+                                                 _votes(_self, app),
+                                                 _stakes(_self, app),
+                                                 _proposal_comments(_self, app),
+                                                 _funds(_self, app),
+                                                 _payouts(_self, app),
+                                                 _proposal_rows(_proposals),
+                                                 _proposal_body_rows(_proposal_bodies),
+                                                 _tspec_rows(_tspec_apps),
+                                                 _fund_rows(_funds)
   {
   }
 
+  /**
+   * @brief flush_rows writes the rows kept by the action, the dispatcher calls it after the action has returned.
+   * An action that fails an eosio_assert doesn't get here, so the rows of a failed action are never written
+   */
+  void flush_rows()
+  {
+    archive_closed_proposals();
+    _proposal_rows.flush();
+    _proposal_body_rows.flush();
+    _tspec_rows.flush();
+    _fund_rows.flush();
+
+    if (_stats_loaded)
+    {
+      _stats.set(_stats_row, _self);
+    }
+  }
+
   /**
    * @brief createpool creates workers pool in the application domain
    * @param token_symbol application domain name
+   * @param comment_mode 0 - the tables keep the text of the comments, 1 - only its sha256. Look at the state_t::comment_mode_t
    */
   /// @abi action
-  void createpool(symbol_name token_symbol)
+  void createpool(symbol_name token_symbol, uint8_t comment_mode)
   {
-    LOG("creating worker's pool: code=\"%\" app=\"%\"", name{_self}.to_string().c_str(), name{_app}.to_string().c_str());
+    LOG_INFO("creating worker's pool: code=\"%\" app=\"%\"", name{_self}.to_string().c_str(), name{_app}.to_string().c_str());
     eosio_assert(!_state.exists(), "workers pool is already initialized for the specified app domain");
+    eosio_assert(comment_mode == state_t::COMMENTS_STORED || comment_mode == state_t::COMMENTS_HASHED, "invalid comment mode");
+    require_auth(_app);
+
+    _state.set(state_t{.token_symbol = token_symbol, .comment_mode = comment_mode}, _app);
+  }
+
+  /**
+   * @brief setdelegates sets the current delegates of the application domain, each delegate occupies a voting slot
+   * @param delegates delegate account names, at most 32
+   */
+  /// @abi action
+  void setdelegates(const vector<account_name> &delegates)
+  {
+    LOG("delegates: %", delegates.size());
     require_auth(_app);
 
-    _state.set(state_t{.token_symbol = token_symbol}, _app);
+    auto registry = get_delegates();
+    registry.set_delegates(delegates);
+    _delegates.set(registry, _app);
   }
 
   /**
@@ -493,23 +1032,30 @@ public:
    * @param description proposal description
    */
   /// @abi action
-  void addpropos(proposal_id_t proposal_id, account_name author, string title, string description)
+  void addpropos(proposal_id_t proposal_id, account_name author, const string_ref &title, const string_ref &description)
   {
     require_app_member(author);
+    require_new_proposal_id(proposal_id);
 
-    LOG("adding propos % \"%\" by %", proposal_id, title.c_str(), ACCOUNT_NAME_CSTR(author));
+    LOG("adding propos % \"%\" by %", proposal_id, title, ACCOUNT_NAME_CSTR(author));
 
     get_proposals().emplace(author, [&](auto &o) {
       o.id = proposal_id;
       o.type = proposal_t::TYPE_1;
       o.author = author;
-      o.title = title;
-      o.description = description;
       o.created = TIMESTAMP_NOW;
       o.modified = TIMESTAMP_UNDEFINED;
       o.state = (uint8_t)proposal_t::STATE_TSPEC_APP;
+      o.voting_deadline = voting_deadline(o.created);
       o.fund_name = _app;
     });
+    modify_stats().proposals[proposal_t::STATE_TSPEC_APP] += 1;
+
+    get_proposal_bodies().emplace(author, [&](proposal_body_t &o) {
+      o.id = proposal_id;
+      o.title = title;
+      o.description = description;
+    });
     LOG("added");
   }
 
@@ -524,31 +1070,43 @@ public:
    */
   /// @abi action
   void addpropos2(proposal_id_t proposal_id, account_name author,
-                  const string &title, const string &description,
+                  const string_ref &title, const string_ref &description,
                   const tspec_data_t &specification, account_name worker)
   {
-    require_app_member(author);
+    require_staked_member(author);
+    require_new_proposal_id(proposal_id);
+    eosio_assert(specification.payments_count > 0, "payments count must be positive");
 
-    LOG("adding propos % \"%\" by %", proposal_id, title.c_str(), name{author}.to_string().c_str());
+    LOG("adding propos % \"%\" by %", proposal_id, title, name{author}.to_string().c_str());
 
     get_proposals().emplace(author, [&](proposal_t &o) {
       o.id = proposal_id;
       o.type = proposal_t::TYPE_2;
       o.author = author;
-      o.title = title;
-      o.description = description;
       o.created = TIMESTAMP_NOW;
       o.modified = TIMESTAMP_UNDEFINED;
       o.state = (uint8_t)proposal_t::STATE_TSPEC_APP;
-      o.tspec = specification;
+      o.voting_deadline = voting_deadline(o.created);
+      o.tspec.set(specification);
       o.fund_name = _app;
+    });
+    modify_stats().proposals[proposal_t::STATE_TSPEC_APP] += 1;
 
-      o.tspec_apps.push_back(tspec_app_t{
-          .id = 0,
-          .author = author,
-          .data = specification,
-          .created = TIMESTAMP_NOW,
-          .modified = TIMESTAMP_UNDEFINED});
+    get_proposal_bodies().emplace(author, [&](proposal_body_t &o) {
+      o.id = proposal_id;
+      o.title = title;
+      o.description = description;
+      o.tspec_text = specification.text;
+    });
+
+    get_tspec_apps().emplace(author, [&](tspec_app_t &spec) {
+      spec.id = get_tspec_apps().available_primary_key();
+      spec.proposal_id = proposal_id;
+      spec.tspec_id = 0;
+      spec.author = author;
+      spec.data = specification;
+      spec.created = TIMESTAMP_NOW;
+      spec.modified = TIMESTAMP_UNDEFINED;
     });
   }
 
@@ -561,24 +1119,25 @@ public:
   /// @abi action
   void setfund(proposal_id_t proposal_id, account_name fund_name, asset quantity)
   {
-    auto proposal_ptr = get_proposals().find(proposal_id);
-    eosio_assert(proposal_ptr != get_proposals().end(), "proposal has not been found");
+    auto &proposal = get_proposal(proposal_id);
     require_app_member(fund_name);
 
-    eosio_assert(proposal_ptr->deposit.amount == 0, "fund is already deposited");
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
+    eosio_assert(proposal.deposit.amount == 0, "fund is already deposited");
+    eosio_assert(proposal.state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
 
-    auto fund_ptr = get_fund(fund_name);
-    eosio_assert(fund_ptr->quantity >= quantity, "insufficient funds");
+    auto &fund = get_fund(fund_name);
+    eosio_assert(fund.quantity >= quantity, "insufficient funds");
 
-    get_proposals().modify(proposal_ptr, fund_name, [&](auto &o) {
-      o.fund_name = fund_name;
-      o.deposit = quantity;
-    });
+    proposal.fund_name = fund_name;
+    proposal.deposit = quantity;
+    _proposal_rows.modify(proposal, fund_name);
 
-    get_funds().modify(fund_ptr, fund_name, [&](auto &fund) {
-      fund.quantity -= quantity;
-    });
+    fund.quantity -= quantity;
+    _fund_rows.modify(fund, fund_name);
+
+    auto &stats = modify_stats();
+    stats.funds -= quantity;
+    stats.deposits += quantity;
   }
 
   /**
@@ -588,46 +1147,65 @@ public:
    * @param description a new description, live empty if no changes are required
    */
   /// @abi action
-  void editpropos(proposal_id_t proposal_id, string title, string description)
+  void editpropos(proposal_id_t proposal_id, const string_ref &title, const string_ref &description)
   {
-    auto proposal_ptr = get_proposal(proposal_id);
-    require_app_member(proposal_ptr->author);
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
+    auto &proposal = get_proposal(proposal_id);
+    require_app_member(proposal.author);
+    eosio_assert(proposal.state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
 
-    get_proposals().modify(proposal_ptr, proposal_ptr->author, [&](auto &o) {
-      bool modified = false;
-      if (!description.empty())
-      {
-        o.description = description;
-        modified = true;
-      }
-      if (!title.empty())
-      {
-        o.title = title;
-        modified = true;
-      }
+    if (title.empty() && description.empty())
+    {
+      return;
+    }
 
-      if (modified)
-      {
-        o.modified = block_timestamp(now());
-      }
-    });
+    auto &body = get_proposal_body(proposal_id);
+    if (!description.empty())
+    {
+      body.description = description;
+    }
+    if (!title.empty())
+    {
+      body.title = title;
+    }
+    _proposal_body_rows.modify(body, proposal.author);
+
+    proposal.modified = block_timestamp(now());
+    _proposal_rows.modify(proposal, proposal.author);
   }
 
   /**
-  * @brief delpropos deletes proposal
+  * @brief delpropos deletes proposal, the deposit goes back to the fund. The applications, comments and votes
+  * are erased first by max_count rows a call, the proposal is erased by the call that erases the last of them
   * @param proposal_id proposal ID to delete
+  * @param max_count maximum number of the applications, comments and votes to erase in this call
   */
   /// @abi action
-  void delpropos(proposal_id_t proposal_id)
+  void delpropos(proposal_id_t proposal_id, uint32_t max_count)
   {
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
-    eosio_assert(proposal_ptr->votes.upvotes.size() == 0, "proposal has been approved by one member");
-    eosio_assert(proposal_ptr->type == proposal_t::TYPE_1, "unsupported action");
+    auto &proposal = get_proposal(proposal_id);
+    eosio_assert(proposal.state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
+    eosio_assert(proposal.votes.upvotes_count == 0, "proposal has been approved by one member");
+    eosio_assert(proposal.type == proposal_t::TYPE_1, "unsupported action");
+
+    require_app_member(proposal.author);
+
+    if (!prune_proposal(proposal_id, max_count))
+    {
+      return;
+    }
+
+    if (proposal.deposit.amount > 0)
+    {
+      refund(proposal, proposal.author);
+    }
+
+    // erased rows can't stay in the cache
+    _proposal_body_rows.forget(proposal_id);
+    get_proposal_bodies().erase(get_proposal_bodies().get(proposal_id, "proposal has not been found"));
+    _proposal_rows.forget(proposal_id);
+    get_proposals().erase(get_proposals().get(proposal_id, "proposal has not been found"));
 
-    require_app_member(proposal_ptr->author);
-    get_proposals().erase(proposal_ptr);
+    count_down(modify_stats().proposals[proposal_t::STATE_TSPEC_APP]);
   }
 
   /**
@@ -639,14 +1217,7 @@ public:
   /// @abi action
   void votepropos(proposal_id_t proposal_id, account_name author, uint8_t vote)
   {
-    auto proposal_ptr = get_proposals().find(proposal_id);
-    eosio_assert(proposal_ptr != get_proposals().end(), "proposal has not been found");
-    eosio_assert(voting_time_s + proposal_ptr->created.to_time_point().sec_since_epoch() >= now(), "voting time is over");
-    require_app_member(author);
-
-    get_proposals().modify(proposal_ptr, author, [&](auto &o) {
-      o.votes.vote(author, static_cast<voting_module_t::vote_value_t>(vote));
-    });
+    vote_proposal(proposal_id, author, vote);
   }
 
   /**
@@ -659,13 +1230,7 @@ public:
   /// @abi action
   void addcomment(proposal_id_t proposal_id, comment_id_t comment_id, account_name author, const comment_data_t &data)
   {
-    LOG("proposal_id: %, comment_id: %, author: %", proposal_id, comment_id, ACCOUNT_NAME_CSTR(author));
-    auto proposal_ptr = get_proposal(proposal_id);
-    require_app_member(author);
-
-    get_proposals().modify(proposal_ptr, author, [&](auto &proposal) {
-      proposal.comments.add(comment_id, author, data);
-    });
+    add_comment(proposal_id, comment_id, author, data);
   }
 
   /**
@@ -678,11 +1243,21 @@ public:
   void editcomment(proposal_id_t proposal_id, comment_id_t comment_id, const comment_data_t &data)
   {
     LOG("proposal_id: %, comment_id: %", proposal_id, comment_id);
-    auto proposal_ptr = get_proposal(proposal_id);
-    auto comment_ptr = proposal_ptr->comments.lookup(comment_id);
+    const auto &comment = get_proposal_comment(proposal_id, comment_id);
+    require_auth(comment.author);
+
+    if (data.text.empty())
+    {
+      return;
+    }
+
+    checksum256 text_hash;
+    const auto kept = keep_comment(comment_t::TARGET_PROPOSAL, proposal_id, comment_id, comment.author, data, text_hash);
 
-    get_proposals().modify(proposal_ptr, comment_ptr->author, [&](auto &proposal) {
-      proposal.comments.edit(comment_id, data);
+    get_proposal_comments().modify(comment, comment.author, [&](auto &comment) {
+      comment.data = kept;
+      comment.text_hash = text_hash;
+      comment.modified = TIMESTAMP_NOW;
     });
   }
 
@@ -695,12 +1270,10 @@ public:
   void delcomment(proposal_id_t proposal_id, comment_id_t comment_id)
   {
     LOG("proposal_id: %, comment_id: %", proposal_id, comment_id);
-    auto proposal_ptr = get_proposal(proposal_id);
-    auto comment_ptr = proposal_ptr->comments.lookup(comment_id);
+    const auto &comment = get_proposal_comment(proposal_id, comment_id);
+    require_auth(comment.author);
 
-    get_proposals().modify(proposal_ptr, comment_ptr->author, [&](auto &proposal) {
-      proposal.comments.del(comment_id);
-    });
+    get_proposal_comments().erase(comment);
   }
 
   /**
@@ -714,22 +1287,26 @@ public:
   void addtspec(proposal_id_t proposal_id, tspec_id_t tspec_id, account_name author, const tspec_data_t &tspec)
   {
     LOG("proposal_id: %, tspec_id: %, author: %", proposal_id, tspec_id, ACCOUNT_NAME_CSTR(author));
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->type == proposal_t::TYPE_1, "unsupported action");
-
-    const auto tspec_ptr = get_tspec(*proposal_ptr, tspec_id);
-    eosio_assert(tspec_ptr == proposal_ptr->tspec_apps.end(),
+    const auto &proposal = get_proposal(proposal_id);
+    eosio_assert(proposal.type == proposal_t::TYPE_1, "unsupported action");
+    // the applications can't be added after the technical specification is chosen
+    eosio_assert(proposal.state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
+    eosio_assert(proposal.voting_deadline >= now(), "proposal has expired");
+    eosio_assert(tspec.payments_count > 0, "payments count must be positive");
+    require_staked_member(author);
+
+    auto index = get_tspec_apps().get_index<N(proposal)>();
+    eosio_assert(index.find(tspec_app_t::make_key(proposal_id, tspec_id)) == index.end(),
                  "technical specification is already exists with the same id");
 
-    get_proposals().modify(proposal_ptr, author, [&](auto &o) {
-      tspec_app_t spec;
-      spec.id = tspec_id;
+    get_tspec_apps().emplace(author, [&](tspec_app_t &spec) {
+      spec.id = get_tspec_apps().available_primary_key();
+      spec.proposal_id = proposal_id;
+      spec.tspec_id = tspec_id;
       spec.author = author;
       spec.created = TIMESTAMP_NOW;
       spec.modified = TIMESTAMP_UNDEFINED;
       spec.data = tspec;
-
-      o.tspec_apps.push_back(spec);
     });
   }
 
@@ -744,21 +1321,21 @@ public:
   void edittspec(proposal_id_t proposal_id, tspec_id_t tspec_app_id, const tspec_data_t &tspec)
   {
     LOG("proposal_id: %, tspec_id: %", proposal_id, tspec_app_id);
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
-    eosio_assert(proposal_ptr->type == proposal_t::TYPE_1, "unsupported action");
+    const auto &proposal = get_proposal(proposal_id);
+    eosio_assert(proposal.state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
+    eosio_assert(proposal.type == proposal_t::TYPE_1, "unsupported action");
 
-    const auto tspec_ptr = get_tspec(*proposal_ptr, tspec_app_id);
-    eosio_assert(tspec_ptr != proposal_ptr->tspec_apps.end(), "technical specification doesn't exist");
-    eosio_assert(tspec.specification_cost.symbol == get_state().token_symbol, "invalid token symbol");
-    eosio_assert(tspec.development_cost.symbol == get_state().token_symbol, "invalid token symbol");
+    auto &tspec_app = get_tspec_app(proposal_id, tspec_app_id);
+    const symbol_name token_symbol = get_state().token_symbol;
+    eosio_assert(tspec.specification_cost.symbol == token_symbol, "invalid token symbol");
+    eosio_assert(tspec.development_cost.symbol == token_symbol, "invalid token symbol");
 
-    require_app_member(tspec_ptr->author);
+    require_app_member(tspec_app.author);
 
-    get_proposals().modify(proposal_ptr, tspec_ptr->author, [&](auto &o) {
-      auto mtspec_ptr = get_tspec(o, tspec_app_id);
-      mtspec_ptr->modify(tspec);
-    });
+    // 0 keeps the payments count of the application
+    tspec_app.modify(tspec);
+    eosio_assert(tspec_app.data.payments_count > 0, "payments count must be positive");
+    _tspec_rows.modify(tspec_app, tspec_app.author);
   }
 
   /**
@@ -770,17 +1347,14 @@ public:
   void deltspec(proposal_id_t proposal_id, tspec_id_t tspec_app_id)
   {
     LOG("proposal_id: %, tspec_id: %", proposal_id, tspec_app_id);
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->type == proposal_t::TYPE_1, "unsupported action");
+    eosio_assert(get_proposal(proposal_id).type == proposal_t::TYPE_1, "unsupported action");
 
-    auto tspec = get_tspec(*proposal_ptr, tspec_app_id);
-    eosio_assert(tspec != proposal_ptr->tspec_apps.end(), "technical specification doesn't exist");
-    require_app_member(tspec->author);
-    eosio_assert(tspec->votes.upvotes.empty(), "technical specification bid can't be deleted because it already has been upvoted"); //Technical Specification 1.e
+    const auto &tspec = get_tspec(proposal_id, tspec_app_id);
+    require_app_member(tspec.author);
+    // the votes of the removed delegates don't block the deletion
+    eosio_assert(tspec.votes.current_upvotes(get_delegates()) == 0, "technical specification bid can't be deleted because it already has been upvoted"); //Technical Specification 1.e
 
-    get_proposals().modify(proposal_ptr, tspec->author, [&](auto &o) {
-      o.tspec_apps.erase(get_tspec(o, tspec_app_id));
-    });
+    get_tspec_apps().erase(tspec);
   }
 
   /**
@@ -795,39 +1369,7 @@ public:
   /// @abi action
   void votetspec(proposal_id_t proposal_id, tspec_id_t tspec_app_id, account_name author, uint8_t vote, comment_id_t comment_id, const comment_data_t &comment)
   {
-    LOG("proposal_id: %, tpsec_id: %, author: %, vote: %", proposal_id, tspec_app_id, ACCOUNT_NAME_CSTR(author), (int)vote);
-
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_TSPEC_APP, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
-    eosio_assert(proposal_ptr->type == proposal_t::TYPE_1, "unsupported action");
-
-    const auto tspec_ptr = get_tspec(*proposal_ptr, tspec_app_id);
-    eosio_assert(tspec_ptr != proposal_ptr->tspec_apps.end(), "technical specification applicatoin doesn't exist");
-    require_app_delegate(author);
-    eosio_assert(voting_time_s + tspec_ptr->created.to_time_point().sec_since_epoch() >= now(), "voting time is over");
-
-    get_proposals().modify(proposal_ptr, author, [&](auto &o) {
-      auto tspec = get_tspec(o, tspec_app_id);
-      tspec->votes.vote(author, static_cast<voting_module_t::vote_value_t>(vote));
-
-      if (!comment.text.empty())
-      {
-        tspec->comments.add(comment_id, author, comment);
-      }
-
-      switch (vote)
-      {
-      case voting_module_t::VOTE_UP:
-        if (tspec->votes.upvotes.size() >= witness_count_51)
-        {  
-          //TODO: check that all voters are delegates in this moment
-          choose_proposal_tspec(o, *tspec, author);
-        }
-        break;
-      case voting_module_t::VOTE_DOWN:
-        break;
-      }
-    });
+    vote_tspec(get_delegates(), proposal_id, tspec_app_id, author, vote, comment_id, comment);
   }
 
   /**
@@ -839,14 +1381,22 @@ public:
   void publishtspec(proposal_id_t proposal_id, const tspec_data_t &data)
   {
     LOG("proposal_id: %", proposal_id);
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_TSPEC_CREATE, "invalid proposal state");
-    eosio_assert(proposal_ptr->type == proposal_t::TYPE_1, "unsupported action");
-    require_auth(proposal_ptr->tspec_author);
+    auto &proposal = get_proposal(proposal_id);
+    eosio_assert(proposal.state == proposal_t::STATE_TSPEC_CREATE, "invalid proposal state");
+    eosio_assert(proposal.type == proposal_t::TYPE_1, "unsupported action");
+    require_auth(proposal.tspec_author);
 
-    get_proposals().modify(proposal_ptr, proposal_ptr->tspec_author, [&](proposal_t &proposal) {
-      proposal.tspec.update(data);
-    });
+    // 0 keeps the payments count of the chosen application
+    proposal.tspec.update(data);
+    eosio_assert(proposal.tspec.payments_count > 0, "payments count must be positive");
+    _proposal_rows.modify(proposal, proposal.tspec_author);
+
+    if (!data.text.empty())
+    {
+      auto &body = get_proposal_body(proposal_id);
+      body.tspec_text = data.text;
+      _proposal_body_rows.modify(body, proposal.tspec_author);
+    }
   }
 
   /**
@@ -858,16 +1408,15 @@ public:
   void startwork(proposal_id_t proposal_id, account_name worker)
   {  
     LOG("proposal_id: %, worker: %", proposal_id, ACCOUNT_NAME_CSTR(worker));
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_TSPEC_CREATE, "invalid proposal state");
-    eosio_assert(proposal_ptr->type == proposal_t::TYPE_1, "unsupported action");
-    require_auth(proposal_ptr->tspec_author);
-
-    get_proposals().modify(proposal_ptr, proposal_ptr->tspec_author, [&](proposal_t &proposal) {
-      proposal.worker = worker;
-      proposal.work_begining_time = TIMESTAMP_NOW;
-      proposal.set_state(proposal_t::STATE_WORK);
-    });
+    auto &proposal = get_proposal(proposal_id);
+    eosio_assert(proposal.state == proposal_t::STATE_TSPEC_CREATE, "invalid proposal state");
+    eosio_assert(proposal.type == proposal_t::TYPE_1, "unsupported action");
+    require_auth(proposal.tspec_author);
+
+    proposal.worker = worker;
+    fix_payment_schedule(proposal);
+    set_proposal_state(proposal, proposal_t::STATE_WORK);
+    _proposal_rows.modify(proposal, proposal.tspec_author);
   }
 
   /**
@@ -879,22 +1428,16 @@ public:
   void cancelwork(proposal_id_t proposal_id, account_name initiator)
   {
     LOG("proposal_id: %, initiator: %", proposal_id, ACCOUNT_NAME_CSTR(initiator));
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_WORK, "invalid proposal state");
-    eosio_assert(proposal_ptr->type == proposal_t::TYPE_1, "unsupported action");
+    auto &proposal = get_proposal(proposal_id);
+    eosio_assert(proposal.state == proposal_t::STATE_WORK, "invalid proposal state");
+    eosio_assert(proposal.type == proposal_t::TYPE_1, "unsupported action");
 
-    if (initiator == proposal_ptr->worker)
-    {
-      require_auth(proposal_ptr->worker);
-    }
-    else
-    {
-      require_auth(proposal_ptr->tspec_author);
-    }
+    // the initiator is the worker or stands for the technical specification author, the one that signs pays
+    const account_name payer = initiator == proposal.worker ? proposal.worker : proposal.tspec_author;
+    require_auth(payer);
 
-    get_proposals().modify(proposal_ptr, initiator, [&](proposal_t &proposal) {
-      refund(proposal, initiator);
-    });
+    refund(proposal, payer);
+    _proposal_rows.modify(proposal, payer);
   }
 
   /**
@@ -907,20 +1450,7 @@ public:
   /// @abi action
   void poststatus(proposal_id_t proposal_id, comment_id_t comment_id, const comment_data_t &comment, bool finished)
   {
-    LOG("proposal_id: %, comment: %, final: %", proposal_id, comment.text.c_str(), (int) finished);
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_WORK, "invalid proposal state");
-    eosio_assert(proposal_ptr->type == proposal_t::TYPE_1, "unsupported action");
-    require_auth(proposal_ptr->worker);
-
-    get_proposals().modify(proposal_ptr, proposal_ptr->worker, [&](auto &proposal) {
-      proposal.work_status.add(comment_id, proposal.worker, comment);
-
-      if (finished)
-      {
-        proposal.set_state(proposal_t::STATE_TSPEC_AUTHOR_REVIEW);
-      }
-    });
+    post_status(proposal_id, comment_id, comment, finished);
   }
 
   /**
@@ -933,15 +1463,20 @@ public:
   void acceptwork(proposal_id_t proposal_id, comment_id_t comment_id, const comment_data_t &comment)
   {
     LOG("proposal_id: %, comment: %", proposal_id, comment.text.c_str());
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_TSPEC_AUTHOR_REVIEW, "invalid proposal state");
-    eosio_assert(proposal_ptr->type == proposal_t::TYPE_1, "unsupported action");
-    require_auth(proposal_ptr->tspec_author);
-
-    get_proposals().modify(proposal_ptr, proposal_ptr->tspec_author, [&](auto &proposal) {
-      proposal.set_state(proposal_t::STATE_DELEGATES_REVIEW);
-      proposal.work_status.add(comment_id, proposal.tspec_author, comment);
-    });
+    auto &proposal = get_proposal(proposal_id);
+    eosio_assert(proposal.state == proposal_t::STATE_TSPEC_AUTHOR_REVIEW, "invalid proposal state");
+    eosio_assert(proposal.type == proposal_t::TYPE_1, "unsupported action");
+    require_auth(proposal.tspec_author);
+
+    set_proposal_state(proposal, proposal_t::STATE_DELEGATES_REVIEW);
+    _proposal_rows.modify(proposal, proposal.tspec_author);
+
+    checksum256 text_hash;
+    const auto kept = keep_comment(comment_t::TARGET_WORK_STATUS, proposal_id, comment_id, proposal.tspec_author, comment, text_hash);
+
+    auto &body = get_proposal_body(proposal_id);
+    body.work_status.add(comment_id, proposal.tspec_author, kept, text_hash);
+    _proposal_body_rows.modify(body, proposal.tspec_author);
   }
 
   /**
@@ -955,134 +1490,467 @@ public:
   /// @abi action
   void reviewwork(proposal_id_t proposal_id, account_name reviewer, uint8_t status, comment_id_t comment_id, const comment_data_t &comment)
   {
-    LOG("proposal_id: %, comment: %, status: %, reviewer: %", proposal_id, comment.text.c_str(), (int) status, ACCOUNT_NAME_CSTR(reviewer));
-    require_app_delegate(reviewer);
-    auto proposal_ptr = get_proposal(proposal_id);
-    require_app_delegate(reviewer);
-    get_proposals().modify(proposal_ptr, reviewer, [&](proposal_t &proposal) {
-      switch (status)
-      {
-      case proposal_t::STATUS_REJECT:
-        eosio_assert(proposal.state == proposal_t::STATE_DELEGATES_REVIEW ||
-                         proposal.state == proposal_t::STATE_WORK ||
-                         proposal.state == proposal_t::STATE_TSPEC_AUTHOR_REVIEW,
-                     "invalid state " __FILE__ ":" TOSTRING(__LINE__));
-
-        proposal.review_votes.downvote(reviewer);
-
-        if (proposal.review_votes.downvotes.size() >= wintess_count_75)
-        {  
-          //TODO: check that all voters are delegates in this moment
-          LOG("work has been rejected by the delegates voting, got % negative votes", proposal.review_votes.downvotes.size());
-          refund(proposal, reviewer);
-          close(proposal);
-        }
-        break;
+    review_work(get_delegates(), proposal_id, reviewer, status, comment_id, comment);
+  }
 
-      case proposal_t::STATUS_ACCEPT:
-        eosio_assert(proposal_ptr->state == proposal_t::STATE_DELEGATES_REVIEW, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
-        proposal.review_votes.upvote(reviewer);
-        if (proposal.review_votes.upvotes.size() >= witness_count_51)
-        {
-          //TODO: check that all voters are delegates in this moment
-          LOG("work has been accepted by the delegates voting, got % positive votes", proposal.review_votes.upvotes.size());
-          pay_tspec_author(proposal);
-          enable_worker_reward(proposal);
-        }
+  /**
+   * @brief batch applies several operations in order with the same checks as the corresponding actions.
+   * Each proposal and technical specification application is read once and written once after the last operation
+   * @param ops operations, look at the batch_op_t
+   */
+  /// @abi action
+  void batch(const vector<batch_op_t> &ops)
+  {
+    LOG("operations: %", ops.size());
+    const auto delegates = get_delegates();
 
+    for (const auto &op : ops)
+    {
+      switch (op.type)
+      {
+      case batch_op_t::OP_VOTEPROPOS:
+        vote_proposal(op.proposal_id, op.author, op.value);
+        break;
+      case batch_op_t::OP_ADDCOMMENT:
+        add_comment(op.proposal_id, op.comment_id, op.author, op.comment);
+        break;
+      case batch_op_t::OP_VOTETSPEC:
+        vote_tspec(delegates, op.proposal_id, op.tspec_id, op.author, op.value, op.comment_id, op.comment);
+        break;
+      case batch_op_t::OP_POSTSTATUS:
+        post_status(op.proposal_id, op.comment_id, op.comment, op.value);
+        break;
+      case batch_op_t::OP_REVIEWWORK:
+        review_work(delegates, op.proposal_id, op.author, op.value, op.comment_id, op.comment);
         break;
-
       default:
-        eosio_assert(false, "invalid review status");
+        eosio_assert(false, "invalid batch operation");
       }
-    });
+    }
   }
 
   /**
-   * @brief withdraw withdraws scheduled payment to the worker account
+   * @brief withdraw transfers all the payments vested so far to the worker account
    * @param proposal_id proposal id
    */
   /// @abi action
   void withdraw(proposal_id_t proposal_id)
   {
     LOG("proposal_id: %", proposal_id);
-    auto proposal_ptr = get_proposal(proposal_id);
-    eosio_assert(proposal_ptr->state == proposal_t::STATE_PAYMENT, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
-    require_auth(proposal_ptr->worker);
+    auto &proposal = get_proposal(proposal_id);
+    eosio_assert(proposal.state == proposal_t::STATE_PAYMENT, "invalid state " __FILE__ ":" TOSTRING(__LINE__));
+    require_auth(proposal.worker);
+    eosio_assert(is_payment_due(proposal), "can't withdraw right now");
+
+    const asset quantity = pay_worker(proposal, proposal.worker);
+    _proposal_rows.modify(proposal, proposal.worker);
+
+    action(
+        permission_level{_self, N(active)},
+        TOKEN_ACCOUNT, N(transfer),
+        std::make_tuple(_self, proposal.worker,
+                        quantity, std::string("worker reward")))
+        .send();
+  }
 
-    asset quantity;
+  /**
+   * @brief processpays makes the due payments to the workers in the order of the payout queue,
+   * the payments to the same worker are sent in one transfer. Anyone can call it
+   * @param max_count maximum number of the payments to make
+   */
+  /// @abi action
+  void processpays(uint32_t max_count)
+  {
+    LOG("max_count: %", max_count);
+    std::map<account_name, asset> transfers;
 
-    if (proposal_ptr->tspec.payments_count == 1)
+    auto index = get_payouts().get_index<N(due)>();
+    for (uint32_t processed = 0; processed < max_count; processed++)
     {
-      quantity = proposal_ptr->tspec.development_cost;
+      // the paid proposal moves in the queue, the first one is the next to pay
+      auto payout_ptr = index.begin();
+      if (payout_ptr == index.end())
+      {
+        break;
+      }
+
+      auto &proposal = get_proposal(payout_ptr->proposal_id);
+      if (!is_payment_due(proposal))
+      {
+        break;
+      }
+
+      // the worker hasn't signed the crank, the contract pays for the summary
+      const asset quantity = pay_worker(proposal, _self);
+      // payer 0 keeps the payer of the row
+      _proposal_rows.modify(proposal, 0);
+
+      auto transfer = transfers.find(proposal.worker);
+      if (transfer == transfers.end())
+      {
+        transfers.emplace(proposal.worker, quantity);
+      }
+      else
+      {
+        transfer->second += quantity;
+      }
     }
-    else
+
+    for (const auto &transfer : transfers)
     {
-      const uint32_t payment_interval = proposal_ptr->tspec.development_eta.to_time_point().sec_since_epoch() / proposal_ptr->tspec.payments_count;
-      const uint32_t payment_epoch = (now() - proposal_ptr->work_begining_time.to_time_point().sec_since_epoch()) / payment_interval;
-      LOG("payment epoch: %, interval: %s, worker payments: %", payment_epoch, payment_interval, int(proposal_ptr->worker_payments_count));
-      eosio_assert(payment_epoch > proposal_ptr->worker_payments_count, "can't withdraw right now");
+      action(permission_level{_self, N(active)},
+             TOKEN_ACCOUNT, N(transfer),
+             std::make_tuple(_self, transfer.first, transfer.second, std::string("worker reward")))
+          .send();
+    }
+  }
+
+  /**
+   * @brief expire closes the proposals that haven't chosen a technical specification before the voting deadline.
+   * Their applications are erased, the deposits go back to the funds. Anyone can call it, the proposals
+   * are taken in the order of the deadlines and an expired one leaves the order, so the next call continues
+   * where the previous one has stopped
+   * @param max_count maximum number of the proposals and applications to process
+   */
+  /// @abi action
+  void expire(uint32_t max_count)
+  {
+    LOG("max_count: %", max_count);
+    const auto delegates = get_delegates();
+    uint32_t budget = max_count;
 
-      quantity = proposal_ptr->tspec.development_cost / proposal_ptr->tspec.payments_count;
+    // the proposals table isn't modified before flush_rows(), the iterator stays valid
+    auto index = get_proposals().get_index<N(deadline)>();
+    for (auto proposal_ptr = index.begin(); budget > 0 && proposal_ptr != index.end() && proposal_ptr->by_deadline() < now(); ++proposal_ptr)
+    {
+      // the proposal is charged after its applications, every call makes progress
+      if (!prune_tspec_apps(proposal_ptr->id, budget) || budget == 0)
+      {
+        break;
+      }
+      budget--;
 
-      if (proposal_ptr->worker_payments_count + 1 == proposal_ptr->tspec.payments_count)
+      auto &proposal = get_proposal(proposal_ptr->id);
+      asset refunded = ZERO_ASSET;
+      if (proposal.deposit.amount > 0)
       {
-        quantity += asset(proposal_ptr->tspec.development_cost.amount % proposal_ptr->tspec.payments_count, quantity.symbol);
+        refunded = proposal.deposit;
+        refund(proposal, _self);
       }
+      LOG_INFO("proposal % has expired", proposal.id);
+      close(proposal, delegates, proposal_summary_t::OUTCOME_EXPIRED, refunded, _self);
+      _proposal_rows.modify(proposal, 0);
     }
+  }
+
+  /**
+   * @brief prunepropos erases the technical specification applications, the comments and the votes of a closed proposal
+   * whose retention period is over, the RAM goes back to their authors. Anyone can call it, the rows remain in the history of the actions that created them
+   * @param proposal_id ID of the closed proposal
+   * @param max_count maximum number of the rows to erase in this call
+   */
+  /// @abi action
+  void prunepropos(proposal_id_t proposal_id, uint32_t max_count)
+  {
+    LOG("proposal_id: %, max_count: %", proposal_id, max_count);
+    const auto &summary = get_proposal_summaries().get(proposal_id, "proposal hasn't been closed");
+    eosio_assert(retention_over(summary), "retention period isn't over");
+    prune_proposal(proposal_id, max_count);
+  }
+
+  /**
+   * @brief updstake takes a new snapshot of the member stake before the end of the epoch,
+   * sent by the vesting contract or by a keeper of the application when the balance changes
+   * @param member account whose vesting balance has been changed
+   */
+  /// @abi action
+  void updstake(account_name member)
+  {
+    eosio_assert(has_auth(VESTING_ACCOUNT) || has_auth(_app), "vesting contract or application domain authority is required");
+    snapshot_stake(get_stakes().find(member), member, _self);
+  }
+
+  /**
+   * @brief setretention sets how long the summaries of the closed proposals are kept before cleanup erases them
+   * @param retention_s retention period in seconds
+   */
+  /// @abi action
+  void setretention(uint32_t retention_s)
+  {
+    LOG("retention: %", retention_s);
+    require_auth(_app);
+
+    state_t state = get_state();
+    state.retention_s = retention_s;
+    _state.set(state, _app);
+  }
+
+  /**
+   * @brief cleanup erases the closed proposals whose retention period is over, with their applications, comments and votes.
+   * Anyone can call it, a call processes at most max_count rows and sends the cleanedup action with the cursor to continue from
+   * @param cursor proposal ID to start from, 0 for the first call
+   * @param max_count maximum number of the rows to process, the summaries that are kept count too
+   */
+  /// @abi action
+  void cleanup(proposal_id_t cursor, uint32_t max_count)
+  {
+    LOG("cursor: %, max_count: %", cursor, max_count);
+    eosio_assert(max_count > 0, "max_count should be positive");
 
-    get_proposals().modify(proposal_ptr, proposal_ptr->worker, [&](proposal_t &proposal) {
-      proposal.deposit -= quantity;
-      proposal.worker_payments_count += 1;
+    uint32_t budget = max_count;
 
-      if (proposal.worker_payments_count == proposal.tspec.payments_count)
+    auto &summaries = get_proposal_summaries();
+    auto summary_ptr = summaries.lower_bound(cursor);
+    while (budget > 0 && summary_ptr != summaries.end())
+    {
+      budget--;
+      if (!retention_over(*summary_ptr))
       {
-        close(proposal);
+        ++summary_ptr;
+        continue;
       }
-    });
 
-    action(
-        permission_level{_self, N(active)},
-        TOKEN_ACCOUNT, N(transfer),
-        std::make_tuple(_self, proposal_ptr->worker,
-                        quantity, std::string("worker reward")))
+      // the budget is over before the last comment or vote, the next call resumes from this proposal
+      if (!prune_proposal(summary_ptr->id, budget))
+      {
+        break;
+      }
+      summary_ptr = summaries.erase(summary_ptr);
+    }
+
+    const bool done = summary_ptr == summaries.end();
+    action(permission_level{_self, N(active)},
+           _self, N(cleanedup),
+           std::make_tuple(_app, max_count - budget, done ? proposal_id_t(0) : summary_ptr->id, done))
         .send();
   }
 
-  // https://tbfleming.github.io/cib/eos.html#gist=d230f3ab2998e8858d3e51af7e4d9aeb
-  static void transfer(uint64_t code, currency::transfer &t)
+  /**
+   * @brief cleanedup is sent by the contract to itself to report the progress of cleanup
+   * @param processed number of the rows processed by the call
+   * @param next_cursor cursor for the next call
+   * @param done true if the cleanup has passed the last closed proposal
+   */
+  /// @abi action
+  void cleanedup(uint32_t processed, proposal_id_t next_cursor, bool done)
   {
-    print_f("%: transfer % from \"%\" to \"%\"", __FUNCTION__, t.quantity, ACCOUNT_NAME_CSTR(t.from), ACCOUNT_NAME_CSTR(t.to));
+    require_auth(_self);
+  }
+
+  /**
+   * @brief rebuildstats recounts the statistics of the application domain from the proposals and the funds to check them for drift.
+   * A call counts at most max_count rows and keeps the progress in the statsbuild table. The last call replaces the counters
+   * that follow from the rows and sends statsrebuilt, the totals since the creation of the pool are kept
+   * @param max_count maximum number of the rows to count
+   */
+  /// @abi action
+  void rebuildstats(uint32_t max_count)
+  {
+    LOG("max_count: %", max_count);
+    require_auth(_app);
+    eosio_assert(max_count > 0, "max_count should be positive");
+
+    auto rebuild = _stats_rebuild.get_or_default(stats_rebuild_t{
+        .phase = stats_rebuild_t::PHASE_PROPOSALS,
+        .cursor = 0,
+        .stats = make_stats()});
+    uint32_t budget = max_count;
+
+    if (rebuild.phase == stats_rebuild_t::PHASE_PROPOSALS)
+    {
+      auto proposal_ptr = get_proposals().lower_bound(rebuild.cursor);
+      for (; budget > 0 && proposal_ptr != get_proposals().end(); ++proposal_ptr, --budget)
+      {
+        rebuild.stats.proposals[proposal_ptr->state] += 1;
+        // the deposit of a proposal without a fund has no symbol
+        if (proposal_ptr->deposit.amount != 0)
+        {
+          rebuild.stats.deposits += proposal_ptr->deposit;
+        }
+      }
+
+      if (proposal_ptr != get_proposals().end())
+      {
+        rebuild.cursor = proposal_ptr->id;
+        _stats_rebuild.set(rebuild, _self);
+        return;
+      }
+      rebuild.phase = stats_rebuild_t::PHASE_FUNDS;
+      rebuild.cursor = 0;
+    }
+
+    auto fund_ptr = get_funds().lower_bound(rebuild.cursor);
+    for (; budget > 0 && fund_ptr != get_funds().end(); ++fund_ptr, --budget)
+    {
+      rebuild.stats.funds += fund_ptr->quantity;
+    }
 
-    worker self(current_receiver(), eosio::string_to_name(t.memo.c_str()));
-    if (t.to != self._self || t.quantity.symbol == self.get_state().token_symbol || code != TOKEN_ACCOUNT)
+    if (fund_ptr != get_funds().end())
     {
+      rebuild.cursor = fund_ptr->owner;
+      _stats_rebuild.set(rebuild, _self);
       return;
     }
 
-    eosio_assert(t.quantity.is_valid(), "Quntity is invalid");
-    eosio_assert(t.quantity.amount > 0, "Invalid transfer amount");
+    auto &stats = modify_stats();
+    const stats_t previous = stats;
+    stats.proposals = rebuild.stats.proposals;
+    stats.funds = rebuild.stats.funds;
+    stats.deposits = rebuild.stats.deposits;
+
+    action(permission_level{_self, N(active)},
+           _self, N(statsrebuilt),
+           std::make_tuple(_app, previous, stats))
+        .send();
+
+    if (_stats_rebuild.exists())
+    {
+      _stats_rebuild.remove();
+    }
+  }
+
+  /**
+   * @brief statsrebuilt is sent by the contract to itself when rebuildstats is over
+   * @param previous statistics kept by the actions
+   * @param rebuilt statistics recounted from the rows, they differ from the previous ones if the statistics have drifted
+   */
+  /// @abi action
+  void statsrebuilt(const stats_t &previous, const stats_t &rebuilt)
+  {
+    require_auth(_self);
+  }
+
+  /**
+   * @brief propclosed is sent by the contract to itself when a proposal closes, it keeps the summary
+   * of the proposal in the history after the cleanup. The texts are in the actions that have written them,
+   * the content_hash of the summary is the sha256 of the packed proposal_body_t
+   * @param summary summary of the closed proposal
+   */
+  /// @abi action
+  void propclosed(const proposal_summary_t &summary)
+  {
+    require_auth(_self);
+  }
+
+  /**
+   * @brief commented is sent by the contract to itself for every comment posted or edited in the COMMENTS_HASHED mode.
+   * The text is in the data of the calling action, the event is fixed-size to stay under the inline action size limit
+   * @param target_type what the comment is posted to. Look at the comment_t::target_type_t
+   * @param target_id proposal ID or technical specification application row ID
+   * @param comment_id comment ID
+   * @param author author of the comment
+   * @param text_hash sha256 of the text kept in the tables
+   */
+  /// @abi action
+  void commented(uint8_t target_type, uint64_t target_id, comment_id_t comment_id, account_name author, const checksum256 &text_hash)
+  {
+    require_auth(_self);
+  }
+
+  // fixed-size head of currency::transfer, the memo follows it
+  struct transfer_head_t
+  {
+    account_name from;
+    account_name to;
+    int64_t amount;
+    symbol_name symbol;
+  };
+
+  /**
+   * @brief accept_transfer filters the transfer notifications by the raw action data before the transfer is unpacked,
+   * the outgoing transfers of the contract and the transfers of other token contracts stop here.
+   * The symbol isn't checked here, the memo can name several application domains with their own tokens:
+   * deposit rejects a symbol that isn't the token of the domain, so the transfer is aborted and the sender
+   * keeps the tokens
+   */
+  static bool accept_transfer(uint64_t receiver, uint64_t code)
+  {
+    transfer_head_t head;
+    return code == TOKEN_ACCOUNT && peek_action_data(head) && head.to == receiver;
+  }
+
+  /**
+   * @brief deposit credits the fund of the sender in the application domain
+   */
+  static void deposit(account_name receiver, app_domain_t app, account_name from, const asset &quantity)
+  {
+    worker self(receiver, app);
+    eosio_assert(quantity.symbol == self.get_state().token_symbol, "invalid token symbol for the application domain");
+    eosio_assert(quantity.amount > 0, "Invalid transfer amount");
 
-    const account_name &payer = t.to;
+    const account_name payer = receiver;
 
-    auto fund = self.get_funds().find(t.from);
+    auto fund = self.get_funds().find(from);
     if (fund == self.get_funds().end())
     {
       self.get_funds().emplace(payer, [&](auto &fund) {
-        fund.owner = t.from;
-        fund.quantity = t.quantity;
+        fund.owner = from;
+        fund.quantity = quantity;
       });
     }
     else
     {
       self.get_funds().modify(fund, payer, [&](auto &fund) {
-        eosio_assert(fund.owner == t.from, "invalid fund owner");
-        fund.quantity += t.quantity;
+        eosio_assert(fund.owner == from, "invalid fund owner");
+        fund.quantity += quantity;
       });
     }
+
+    auto &stats = self.modify_stats();
+    stats.funds += quantity;
+    stats.transferred += quantity;
+    self.flush_rows();
+  }
+
+  /**
+   * @brief transfer deposits the tokens to the funds of the sender. The memo is an application domain name,
+   * which gets the whole quantity, or a comma-separated list of `app:amount` entries in the smallest token
+   * units, e.g. `app.a:1000,app.b:2500`, whose amounts add up to the quantity
+   */
+  static void transfer(uint64_t code, currency::transfer &t)
+  {
+#if GOLOS_WORKER_LOG_LEVEL >= GOLOS_WORKER_LOG_DEBUG
+    print_f("%: transfer % from \"%\" to \"%\"", __FUNCTION__, t.quantity, ACCOUNT_NAME_CSTR(t.from), ACCOUNT_NAME_CSTR(t.to));
+#endif
+
+    eosio_assert(t.quantity.is_valid(), "Quntity is invalid");
+
+    if (t.memo.find(':') == string::npos)
+    {
+      deposit(t.to, eosio::string_to_name(t.memo.c_str()), t.from, t.quantity);
+      return;
+    }
+
+    int64_t credited = 0;
+    size_t begin = 0;
+    while (begin < t.memo.size())
+    {
+      size_t end = t.memo.find(',', begin);
+      if (end == string::npos)
+      {
+        end = t.memo.size();
+      }
+
+      const size_t colon = t.memo.find(':', begin);
+      eosio_assert(colon < end && colon > begin, "invalid memo, `app:amount` is expected");
+
+      int64_t amount = 0;
+      for (size_t i = colon + 1; i < end; ++i)
+      {
+        const char c = t.memo[i];
+        eosio_assert('0' <= c && c <= '9' && amount <= (asset::max_amount - (c - '0')) / 10, "invalid amount in the memo");
+        amount = amount * 10 + (c - '0');
+      }
+      credited += amount;
+      eosio_assert(credited <= t.quantity.amount, "the amounts in the memo exceed the quantity");
+
+      deposit(t.to, eosio::string_to_name(t.memo.substr(begin, colon - begin).c_str()), t.from, asset(amount, t.quantity.symbol));
+      begin = end + 1;
+    }
+    eosio_assert(credited == t.quantity.amount, "the amounts in the memo don't add up to the quantity");
   }
 };
 } // namespace golos
 
-APP_DOMAIN_ABI(golos::worker, (createpool)(addpropos2)(addpropos)(setfund)(editpropos)(delpropos)(votepropos)(addcomment)(editcomment)(delcomment)(addtspec)(edittspec)(deltspec)(votetspec)(publishtspec)(startwork)(poststatus)(acceptwork)(reviewwork)(cancelwork)(withdraw),
+APP_DOMAIN_ABI(golos::worker, (createpool)(setdelegates)(addpropos2)(addpropos)(setfund)(editpropos)(delpropos)(votepropos)(addcomment)(editcomment)(delcomment)(addtspec)(edittspec)(deltspec)(votetspec)(publishtspec)(startwork)(poststatus)(acceptwork)(reviewwork)(batch)(cancelwork)(withdraw)(processpays)(expire)(prunepropos)(setretention)(updstake)(cleanup)(cleanedup)(rebuildstats)(statsrebuilt)(propclosed)(commented),
                (transfer))
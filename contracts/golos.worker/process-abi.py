@@ -21,7 +21,13 @@ if __name__ == "__main__":
 
     # remove unused types
     abi["structs"] = list(filter(lambda x: x is not None,
-        [struct if struct["name"] not in ["block_timestamp"] else None for struct in abi["structs"]]))
+        [struct if struct["name"] not in ["block_timestamp", "string_ref"] else None for struct in abi["structs"]]))
+
+    # string_ref is a view of a string argument
+    for struct in abi["structs"]:
+        for field in struct["fields"]:
+            if field["type"] == "string_ref":
+                field["type"] = "string"
 
     # patch set_t
     for struct in abi["structs"]:
@@ -0,0 +1,674 @@
+// Rows of the golos.worker tables and the types they are made of. The header builds for wasm and natively
+// (against bench/eosiolib), so the contract and the row decoder of the benchmarks (bench/row_decoder.hpp)
+// share the layout of the rows.
+#pragma once
+
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/currency.hpp>
+#include <eosiolib/time.hpp>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "external.hpp"
+#include "structs.hpp"
+
+#define TIMESTAMP_UNDEFINED block_timestamp(0)
+#define TIMESTAMP_NOW block_timestamp(now())
+
+namespace golos
+{
+
+using namespace ::eosio;
+using std::string;
+
+constexpr uint32_t default_retention_s = 30 * 24 * 3600;
+
+typedef symbol_name app_domain_t;
+typedef uint64_t comment_id_t;
+
+struct comment_data_t
+{
+  string text;
+
+  EOSLIB_SERIALIZE(comment_data_t, (text));
+};
+
+struct comment_t
+{
+  // what a comment is posted to, the target of the commented event
+  enum target_type_t
+  {
+    TARGET_PROPOSAL = 1,
+    TARGET_TSPEC_APP,
+    TARGET_WORK_STATUS
+  };
+
+  comment_id_t id;
+  account_name author;
+  ///< the text is empty in the COMMENTS_HASHED mode
+  comment_data_t data;
+  ///< sha256 of the text in the COMMENTS_HASHED mode
+  checksum256 text_hash;
+  block_timestamp created;
+  block_timestamp modified;
+
+  EOSLIB_SERIALIZE(comment_t, (id)(author)(data)(text_hash)(created)(modified));
+
+  // comments are ordered by ID, set_t<comment_t> is used as a flat map
+  friend bool operator<(const comment_t &a, const comment_t &b) { return a.id < b.id; }
+  friend bool operator<(const comment_t &a, comment_id_t id) { return a.id < id; }
+  friend bool operator<(comment_id_t id, const comment_t &b) { return id < b.id; }
+};
+
+struct comments_module_t
+{
+  set_t<comment_t> comments;
+
+  EOSLIB_SERIALIZE(comments_module_t, (comments));
+
+  void add(comment_id_t id, account_name author, const comment_data_t &data, const checksum256 &text_hash)
+  {
+    comment_t comment{
+        .id = id,
+        .author = author,
+        .data = data,
+        .text_hash = text_hash,
+        .created = TIMESTAMP_NOW,
+        .modified = TIMESTAMP_UNDEFINED};
+
+    eosio_assert(comments.set(comment), "comment with the same id is already exists");
+  }
+
+  auto lookup(comment_id_t id)
+  {
+    auto ptr = comments.find(id);
+    eosio_assert(ptr != comments.end(), "comment doesn't exist");
+    return ptr;
+  }
+
+  const auto lookup(comment_id_t id) const
+  {
+    const auto ptr = comments.find(id);
+    eosio_assert(ptr != comments.end(), "comment doesn't exist");
+    return ptr;
+  }
+};
+
+typedef uint64_t tspec_id_t;
+typedef uint64_t proposal_id_t;
+
+struct tspec_data_t
+{
+  string text;
+  asset specification_cost;
+  block_timestamp specification_eta;
+  asset development_cost;
+  block_timestamp development_eta;
+  uint8_t payments_count;
+
+  EOSLIB_SERIALIZE(tspec_data_t, (text)(specification_cost)(specification_eta)(development_cost)(development_eta)(payments_count));
+
+  void update(const tspec_data_t &that)
+  {
+    if (!that.text.empty())
+    {
+      text = that.text;
+    }
+    if (that.specification_cost.amount != 0)
+    {
+      specification_cost = that.specification_cost;
+    }
+
+    if (that.specification_eta != TIMESTAMP_UNDEFINED)
+    {
+      specification_eta = that.specification_eta;
+    }
+
+    if (that.development_cost.amount != 0)
+    {
+      development_cost = that.development_cost;
+    }
+
+    if (that.development_eta != TIMESTAMP_UNDEFINED)
+    {
+      development_eta = that.development_eta;
+    }
+
+    if (that.payments_count != 0)
+    {
+      payments_count = that.payments_count;
+    }
+  }
+};
+
+// fixed-size part of the tspec_data_t, the text is kept in the proposal body
+struct tspec_terms_t
+{
+  asset specification_cost;
+  block_timestamp specification_eta;
+  asset development_cost;
+  block_timestamp development_eta;
+  uint8_t payments_count;
+
+  EOSLIB_SERIALIZE(tspec_terms_t, (specification_cost)(specification_eta)(development_cost)(development_eta)(payments_count));
+
+  void set(const tspec_data_t &that)
+  {
+    specification_cost = that.specification_cost;
+    specification_eta = that.specification_eta;
+    development_cost = that.development_cost;
+    development_eta = that.development_eta;
+    payments_count = that.payments_count;
+  }
+
+  void update(const tspec_data_t &that)
+  {
+    tspec_data_t data{
+        .specification_cost = specification_cost,
+        .specification_eta = specification_eta,
+        .development_cost = development_cost,
+        .development_eta = development_eta,
+        .payments_count = payments_count};
+
+    data.update(that);
+    set(data);
+  }
+};
+
+struct voting_module_t
+{
+  enum vote_value_t
+  {
+    VOTE_DOWN = 0,
+    VOTE_UP = 1
+  };
+
+  uint32_t upvotes_count = 0;
+  uint32_t downvotes_count = 0;
+  ///< stakes of the voters, kept with the counts so the result doesn't need the votes
+  int64_t upvotes_weight = 0;
+  int64_t downvotes_weight = 0;
+
+  void add(vote_value_t vote, int64_t weight)
+  {
+    switch (vote)
+    {
+    case VOTE_UP:
+      upvotes_count += 1;
+      upvotes_weight += weight;
+      break;
+    case VOTE_DOWN:
+      downvotes_count += 1;
+      downvotes_weight += weight;
+      break;
+    default:
+      eosio_assert(false, "invalid vote argument");
+    }
+  }
+
+  EOSLIB_SERIALIZE(voting_module_t, (upvotes_count)(downvotes_count)(upvotes_weight)(downvotes_weight));
+};
+
+constexpr uint8_t max_delegate_slots = 32;
+static_assert(witness_count <= max_delegate_slots, "delegate votes are stored as 32-bit masks");
+
+//@abi table delegates i64
+struct delegate_registry_t
+{
+  ///< slot owners, a removed delegate keeps the slot until it is given to another account
+  vector<account_name> slots;
+  ///< registry version when each slot was given to its current owner
+  vector<uint32_t> slot_versions;
+  ///< mask of the slots of the current delegates
+  uint32_t active_mask;
+  uint32_t version;
+
+  EOSLIB_SERIALIZE(delegate_registry_t, (slots)(slot_versions)(active_mask)(version));
+
+  uint64_t primary_key() const { return 0; }
+
+  int find_slot(account_name account) const
+  {
+    auto ptr = std::find(slots.begin(), slots.end(), account);
+    return ptr != slots.end() ? ptr - slots.begin() : -1;
+  }
+
+  bool is_active(account_name account) const
+  {
+    const int slot = find_slot(account);
+    return slot >= 0 && (active_mask & (1u << slot));
+  }
+
+  void set_delegates(const vector<account_name> &delegates)
+  {
+    eosio_assert(delegates.size() <= max_delegate_slots, "too many delegates");
+    slots.resize(max_delegate_slots);
+    slot_versions.resize(max_delegate_slots);
+
+    uint32_t mask = 0;
+    for (auto delegate : delegates)
+    {
+      eosio_assert(delegate != 0, "invalid delegate account");
+      const int slot = find_slot(delegate);
+      if (slot >= 0)
+      {
+        eosio_assert(!(mask & (1u << slot)), "duplicate delegate");
+        mask |= 1u << slot;
+      }
+    }
+
+    for (auto delegate : delegates)
+    {
+      if (find_slot(delegate) >= 0)
+      {
+        continue;
+      }
+
+      // prefer slots that were never used, then the ones of the removed delegates
+      int slot = std::find(slots.begin(), slots.end(), 0) - slots.begin();
+      if (slot == max_delegate_slots)
+      {
+        slot = 0;
+        while (mask & (1u << slot))
+        {
+          slot++;
+        }
+      }
+
+      version += 1;
+      slots[slot] = delegate;
+      slot_versions[slot] = version;
+      mask |= 1u << slot;
+    }
+
+    active_mask = mask;
+  }
+};
+
+struct delegate_voting_module_t
+{
+  ///< masks of the delegate slots, see delegate_registry_t
+  uint32_t upvotes = 0;
+  uint32_t downvotes = 0;
+  ///< registry version the masks are consistent with
+  uint32_t version = 0;
+
+  EOSLIB_SERIALIZE(delegate_voting_module_t, (upvotes)(downvotes)(version));
+
+  ///< mask of the slots whose votes count: the current delegates that had their slots when the masks were written
+  uint32_t valid_mask(const delegate_registry_t &registry) const
+  {
+    uint32_t mask = registry.active_mask;
+    if (version != registry.version)
+    {
+      for (uint8_t i = 0; i < max_delegate_slots; i++)
+      {
+        if (registry.slot_versions[i] > version)
+        {
+          mask &= ~(1u << i);
+        }
+      }
+    }
+    return mask;
+  }
+
+  uint32_t current_upvotes(const delegate_registry_t &registry) const { return upvotes & valid_mask(registry); }
+
+  void vote(const delegate_registry_t &registry, uint8_t slot, voting_module_t::vote_value_t vote)
+  {
+    // forget votes of the removed delegates and of the previous owners of the slots,
+    // the masks stored in the row rank the application by the current delegates
+    const uint32_t mask = valid_mask(registry);
+    upvotes &= mask;
+    downvotes &= mask;
+    version = registry.version;
+
+    const uint32_t bit = 1u << slot;
+    eosio_assert(!(upvotes & bit), "already upvoted");
+    eosio_assert(!(downvotes & bit), "already downvoted");
+
+    switch (vote)
+    {
+    case voting_module_t::VOTE_UP:
+      upvotes |= bit;
+      break;
+    case voting_module_t::VOTE_DOWN:
+      downvotes |= bit;
+      break;
+    default:
+      eosio_assert(false, "invalid vote argument");
+    }
+  }
+
+  uint32_t upvotes_count(uint32_t active_mask) const { return __builtin_popcount(upvotes & active_mask); }
+  uint32_t downvotes_count(uint32_t active_mask) const { return __builtin_popcount(downvotes & active_mask); }
+};
+
+//@abi table tspecs i64
+struct tspec_app_t
+{
+  uint64_t id;
+  proposal_id_t proposal_id;
+  tspec_id_t tspec_id;
+  account_name author;
+
+  tspec_data_t data;
+
+  delegate_voting_module_t votes;
+  comments_module_t comments;
+
+  block_timestamp created;
+  block_timestamp modified;
+
+  EOSLIB_SERIALIZE(tspec_app_t, (id)(proposal_id)(tspec_id)(author)(data)(votes)(comments)(created)(modified));
+
+  static uint128_t make_key(proposal_id_t proposal_id, uint64_t value)
+  {
+    return (uint128_t(proposal_id) << 64) | value;
+  }
+
+  uint64_t primary_key() const { return id; }
+  uint128_t by_proposal() const { return make_key(proposal_id, tspec_id); }
+  // the upvotes of the delegates at the last vote, vote() drops the bits of the removed ones
+  uint128_t by_upvotes() const { return make_key(proposal_id, __builtin_popcount(votes.upvotes)); }
+
+  void modify(const tspec_data_t &that)
+  {
+    data.update(that);
+    modified = TIMESTAMP_NOW;
+  }
+};
+
+///< payment schedule of the worker, fixed when the work starts
+struct payment_schedule_t
+{
+  ///< seconds since epoch
+  uint32_t start = 0;
+  ///< the payments vest evenly in this time, all of them at once if it's 0
+  uint32_t duration_s = 0;
+  asset total;
+
+  EOSLIB_SERIALIZE(payment_schedule_t, (start)(duration_s)(total));
+};
+
+//@abi table proposals i64
+struct proposal_t
+{
+  enum state_t
+  {
+    STATE_TSPEC_APP = 1,
+    STATE_TSPEC_CREATE,
+    STATE_WORK,
+    STATE_TSPEC_AUTHOR_REVIEW,
+    STATE_DELEGATES_REVIEW,
+    STATE_PAYMENT,
+    STATE_CLOSED
+  };
+
+  enum review_status_t
+  {
+    STATUS_REJECT = 0,
+    STATUS_ACCEPT = 1
+  };
+
+  enum type_t
+  {
+    TYPE_1,
+    TYPE_2
+  };
+
+  proposal_id_t id;
+  account_name author;
+  uint8_t type;
+  account_name fund_name;
+  asset deposit;
+  voting_module_t votes;
+  ///< technical specification author
+  account_name tspec_author = 0;
+  ///< technical specification terms, the text is in the proposal_body_t
+  tspec_terms_t tspec;
+  ///< perpetrator account name
+  account_name worker = 0;
+  payment_schedule_t payment_schedule;
+  ///< number of the payments made to the worker
+  uint8_t worker_payments_count = 0;
+
+  delegate_voting_module_t review_votes;
+
+  block_timestamp created;
+  block_timestamp modified;
+  uint8_t state;
+  ///< the proposal expires after this deadline if no technical specification is chosen, set at the creation
+  uint32_t voting_deadline = 0;
+
+  EOSLIB_SERIALIZE(proposal_t, (id)(author)(type)(fund_name)(deposit)(votes)(tspec_author)(tspec)(worker)(payment_schedule)(worker_payments_count)(review_votes)(created)(modified)(state)(voting_deadline));
+
+  uint64_t primary_key() const { return id; }
+  uint64_t by_state() const { return state; }
+  uint64_t by_author() const { return author; }
+  uint64_t by_fund() const { return fund_name; }
+  uint64_t by_created() const { return created.slot; }
+  // net stake of the member votes, shifted by 2^63 to keep the signed order
+  uint64_t by_score() const { return uint64_t(votes.upvotes_weight - votes.downvotes_weight) + (1ull << 63); }
+  // only the proposals waiting for a technical specification can expire, the others are at the end
+  uint64_t by_deadline() const { return state == STATE_TSPEC_APP ? voting_deadline : UINT64_MAX; }
+
+  void set_state(state_t new_state) { state = new_state; }
+};
+
+//@abi table funds i64
+struct fund_t
+{
+  account_name owner;
+  asset quantity;
+
+  EOSLIB_SERIALIZE(fund_t, (owner)(quantity));
+
+  uint64_t primary_key() const { return owner; }
+};
+
+//@abi table states i64
+struct state_t
+{
+  enum comment_mode_t
+  {
+    ///< the tables keep the text of the comments
+    COMMENTS_STORED = 0,
+    ///< the tables keep the sha256 of the text, the text is only in the action data and the commented event
+    COMMENTS_HASHED = 1
+  };
+
+  symbol_name token_symbol;
+  ///< how long cleanup keeps the summaries of the closed proposals
+  uint32_t retention_s = default_retention_s;
+  uint8_t comment_mode = COMMENTS_STORED;
+
+  EOSLIB_SERIALIZE(state_t, (token_symbol)(retention_s)(comment_mode));
+
+  uint64_t primary_key() const { return 0; }
+};
+
+// variable-size part of the proposal, rows have the same IDs as the proposals
+//@abi table propbodies i64
+struct proposal_body_t
+{
+  proposal_id_t id;
+  string title;
+  string description;
+  ///< technical specification text
+  string tspec_text;
+  comments_module_t work_status;
+
+  EOSLIB_SERIALIZE(proposal_body_t, (id)(title)(description)(tspec_text)(work_status));
+
+  uint64_t primary_key() const { return id; }
+};
+
+// what is kept of a closed proposal, it's sent in the propclosed action
+//@abi table propsummary i64
+struct proposal_summary_t
+{
+  enum outcome_t
+  {
+    OUTCOME_PAID = 1,
+    OUTCOME_REJECTED,
+    OUTCOME_EXPIRED
+  };
+
+  proposal_id_t id;
+  account_name author;
+  uint8_t type;
+  uint8_t outcome;
+  account_name fund_name;
+  account_name tspec_author;
+  account_name worker;
+  asset tspec_author_paid;
+  asset worker_paid;
+  asset refunded;
+  voting_module_t votes;
+  uint8_t review_upvotes;
+  uint8_t review_downvotes;
+  ///< sha256 of the packed proposal_body_t
+  checksum256 content_hash;
+  block_timestamp created;
+  block_timestamp closed;
+
+  EOSLIB_SERIALIZE(proposal_summary_t, (id)(author)(type)(outcome)(fund_name)(tspec_author)(worker)(tspec_author_paid)(worker_paid)(refunded)(votes)(review_upvotes)(review_downvotes)(content_hash)(created)(closed));
+
+  uint64_t primary_key() const { return id; }
+};
+
+//@abi table comments i64
+struct proposal_comment_t
+{
+  uint64_t id;
+  proposal_id_t proposal_id;
+  comment_id_t comment_id;
+  account_name author;
+  ///< the text is empty in the COMMENTS_HASHED mode
+  comment_data_t data;
+  ///< sha256 of the text in the COMMENTS_HASHED mode
+  checksum256 text_hash;
+  block_timestamp created;
+  block_timestamp modified;
+
+  EOSLIB_SERIALIZE(proposal_comment_t, (id)(proposal_id)(comment_id)(author)(data)(text_hash)(created)(modified));
+
+  static uint128_t make_key(proposal_id_t proposal_id, comment_id_t comment_id)
+  {
+    return (uint128_t(proposal_id) << 64) | comment_id;
+  }
+
+  uint64_t primary_key() const { return id; }
+  uint128_t by_proposal() const { return make_key(proposal_id, comment_id); }
+  uint64_t by_author() const { return author; }
+};
+
+//@abi table votes i64
+struct vote_t
+{
+  enum target_type_t
+  {
+    TARGET_PROPOSAL = 1
+  };
+
+  uint64_t id;
+  uint8_t target_type;
+  uint64_t target_id;
+  account_name voter;
+  uint8_t value;
+  block_timestamp created;
+
+  EOSLIB_SERIALIZE(vote_t, (id)(target_type)(target_id)(voter)(value)(created));
+
+  static key256 make_key(uint8_t target_type, uint64_t target_id, account_name voter)
+  {
+    return key256::make_from_word_sequence<uint64_t>(target_type, target_id, voter, 0);
+  }
+
+  uint64_t primary_key() const { return id; }
+  key256 by_target() const { return make_key(target_type, target_id, voter); }
+};
+
+// stakes of the members taken at their first action in an epoch, votes are weighted with them
+//@abi table stakes i64
+struct stake_t
+{
+  account_name member;
+  int64_t weight;
+  ///< number of the worker::stake_epoch_s epoch when the weight has been read
+  uint32_t epoch;
+
+  EOSLIB_SERIALIZE(stake_t, (member)(weight)(epoch));
+
+  uint64_t primary_key() const { return member; }
+};
+
+// balance table of the vesting contract, it has the layout of the eosio.token accounts table
+struct vesting_balance_t
+{
+  asset balance;
+
+  EOSLIB_SERIALIZE(vesting_balance_t, (balance));
+
+  uint64_t primary_key() const { return balance.symbol.name(); }
+};
+
+// totals of the application domain, every action updates them by the amounts it changes
+//@abi table stats i64
+struct stats_t
+{
+  ///< number of the open proposals in each state, indexed by proposal_t::state_t. The proposals
+  ///< in STATE_TSPEC_APP are the ones with open voting, closed proposals are counted in closed_count
+  vector<uint32_t> proposals;
+  uint64_t closed_count = 0;
+  ///< tokens in the funds
+  asset funds;
+  ///< tokens deposited to the open proposals
+  asset deposits;
+  ///< totals since the creation of the pool
+  asset transferred;
+  asset tspec_author_paid;
+  asset worker_paid;
+  asset refunded;
+
+  EOSLIB_SERIALIZE(stats_t, (proposals)(closed_count)(funds)(deposits)(transferred)(tspec_author_paid)(worker_paid)(refunded));
+
+  uint64_t primary_key() const { return 0; }
+};
+
+// progress of rebuildstats, erased when the rebuild is over
+//@abi table statsbuild i64
+struct stats_rebuild_t
+{
+  enum phase_t
+  {
+    PHASE_PROPOSALS = 0,
+    PHASE_FUNDS
+  };
+
+  uint8_t phase = PHASE_PROPOSALS;
+  ///< primary key of the next proposal or fund to count
+  uint64_t cursor = 0;
+  stats_t stats;
+
+  EOSLIB_SERIALIZE(stats_rebuild_t, (phase)(cursor)(stats));
+
+  uint64_t primary_key() const { return 0; }
+};
+
+// proposals in the STATE_PAYMENT state ordered by the time of the next payment to the worker
+//@abi table payouts i64
+struct payout_t
+{
+  proposal_id_t proposal_id;
+  uint64_t due;
+
+  EOSLIB_SERIALIZE(payout_t, (proposal_id)(due));
+
+  uint64_t primary_key() const { return proposal_id; }
+  uint64_t by_due() const { return due; }
+};
+} // namespace golos
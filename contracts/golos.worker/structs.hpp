@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <functional>
 
 #define EOSLIB_SERIALIZE_DERIVED2( TYPE, BASE ) \
  template<typename DataStream> \
@@ -17,28 +18,61 @@ namespace golos {
 
 using std::vector;
 
+/**
+ * @brief set_t is a sorted vector without duplicates, lookups are binary searches.
+ * Elements are ordered with operator<, which may also compare an element with its key,
+ * e.g. a comment with a comment ID, so the same container works as a flat map.
+ * Serialized as a plain vector, rows written by the unsorted version are sorted when they are read.
+ */
 template <typename T>
 class set_t : public vector<T>
 {
   public:
+    typedef std::less<> compare_t;
+
+    using typename vector<T>::iterator;
+    using typename vector<T>::const_iterator;
     using vector<T>::end;
     using vector<T>::begin;
     using vector<T>::erase;
-    using vector<T>::push_back;
+    using vector<T>::insert;
+
+    template <typename K>
+    iterator find(const K &key)
+    {
+        auto i = std::lower_bound(begin(), end(), key, compare_t());
+        return i != end() && !compare_t()(key, *i) ? i : end();
+    }
 
-    bool has(const T &v) const
+    template <typename K>
+    const_iterator find(const K &key) const
     {
-        return std::find(begin(), end(), v) != end();
+        auto i = std::lower_bound(begin(), end(), key, compare_t());
+        return i != end() && !compare_t()(key, *i) ? i : end();
     }
 
-    void set(const T &v)
+    template <typename K>
+    bool has(const K &v) const
     {
-        push_back(v);
+        return find(v) != end();
     }
 
-    bool unset(const T &v)
+    bool set(const T &v)
     {
-        auto i = find(begin(), end(), v);
+        auto i = std::lower_bound(begin(), end(), v, compare_t());
+        if (i != end() && !compare_t()(v, *i))
+        {
+            return false;
+        }
+
+        insert(i, v);
+        return true;
+    }
+
+    template <typename K>
+    bool unset(const K &v)
+    {
+        auto i = find(v);
         if (i != end())
         {
             erase(i);
@@ -47,7 +81,45 @@ class set_t : public vector<T>
         return false;
     }
 
-    EOSLIB_SERIALIZE_DERIVED2(set_t, vector<T>);
+    bool sorted() const
+    {
+        return std::adjacent_find(begin(), end(), [](const T &a, const T &b) {
+                   return !compare_t()(a, b);
+               }) == end();
+    }
+
+    void normalize()
+    {
+        if (!sorted())
+        {
+            std::sort(begin(), end(), compare_t());
+            erase(std::unique(begin(), end(), [](const T &a, const T &b) {
+                      return !compare_t()(a, b) && !compare_t()(b, a);
+                  }),
+                  end());
+        }
+    }
+
+    template <typename DataStream>
+    friend DataStream &operator<<(DataStream &ds, const set_t &t)
+    {
+        if (t.sorted())
+        {
+            return ds << static_cast<const vector<T> &>(t);
+        }
+
+        set_t copy(t);
+        copy.normalize();
+        return ds << static_cast<const vector<T> &>(copy);
+    }
+
+    template <typename DataStream>
+    friend DataStream &operator>>(DataStream &ds, set_t &t)
+    {
+        ds >> static_cast<vector<T> &>(t);
+        t.normalize();
+        return ds;
+    }
 };
 
 template <typename T>